@@ -0,0 +1,103 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+namespace Keruis::Bench {
+
+    using Clock = std::chrono::steady_clock;
+
+    // 单次测量的上下文：被测代码写成 while (state.keepRunning()) { ... }，循环外的准备工作不计时
+    class State {
+    public:
+        State(std::size_t param, std::size_t iterations) : m_param(param), m_iterations(iterations), m_remaining(iterations) {}
+
+        [[nodiscard]] std::size_t param()      const { return m_param;      }
+        [[nodiscard]] std::size_t iterations() const { return m_iterations; }
+
+        bool keepRunning() {
+            if (m_remaining == m_iterations) m_start = Clock::now();
+            if (m_remaining == 0) {
+                m_end = Clock::now();
+                return false;
+            }
+            --m_remaining;
+            return true;
+        }
+
+        [[nodiscard]] double elapsedNs() const {
+            return std::chrono::duration<double, std::nano>(m_end - m_start).count();
+        }
+
+        // 附加到结果上的自定义计数（例如每帧实际计算的线段数），同名计数以最后一次为准
+        void counter(const std::string& name, double value) {
+            for (auto& [key, v] : m_counters) {
+                if (key == name) { v = value; return; }
+            }
+            m_counters.emplace_back(name, value);
+        }
+
+        [[nodiscard]] auto counters() const -> const std::vector<std::pair<std::string, double>>& { return m_counters; }
+
+    private:
+        std::size_t       m_param;
+        std::size_t       m_iterations;
+        std::size_t       m_remaining;
+        Clock::time_point m_start{};
+        Clock::time_point m_end{};
+
+        std::vector<std::pair<std::string, double>> m_counters;
+    };
+
+    struct Case {
+        std::string                 name;
+        std::vector<std::size_t>    params;
+        std::function<void(State&)> body;
+    };
+
+    struct Result {
+        std::string name;
+        std::size_t param      = 0;
+        std::size_t iterations = 0;
+        double      medianNs   = 0.0;
+        double      minNs      = 0.0;
+
+        std::vector<std::pair<std::string, double>> counters;
+    };
+
+    std::vector<Case>& registry();
+
+    struct Registrar {
+        Registrar(std::string name, std::vector<std::size_t> params, std::function<void(State&)> body) {
+            registry().push_back({std::move(name), std::move(params), std::move(body)});
+        }
+    };
+
+    Result run(const Case& benchCase, std::size_t param);
+
+    // 进程启动以来全局 operator new 的调用次数（main.cpp 替换了 operator new），用于确认被测代码不分配内存
+    std::size_t allocations();
+
+    template <typename Ty_>
+    inline void doNotOptimize(const Ty_& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+}
+
+#define BENCH_CONCAT_IMPL(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_IMPL(a, b)
+
+// 用法：KERUIS_BENCH("Name", {100, 1000}) { while (state.keepRunning()) {...} }
+#define KERUIS_BENCH(NAME, ...) \
+    static void BENCH_CONCAT(_bench_fn_, __LINE__)(Keruis::Bench::State& state); \
+    static Keruis::Bench::Registrar BENCH_CONCAT(_bench_reg_, __LINE__)( \
+        NAME, std::vector<std::size_t> __VA_ARGS__, &BENCH_CONCAT(_bench_fn_, __LINE__)); \
+    static void BENCH_CONCAT(_bench_fn_, __LINE__)([[maybe_unused]] Keruis::Bench::State& state)
+
+#endif //BENCH_H
@@ -0,0 +1,65 @@
+#include "Bench.h"
+
+#include <QImage>
+
+#include "FloatingBallProbe.h"
+
+// 扫过一整圈的角度，param 为第 0 层的扇区数
+KERUIS_BENCH("FloatingBall/getHoveredSegmentFromAngle", {5, 36, 360}) {
+    FloatingBall& ball = FloatingBallProbe::ball();
+    FloatingBallProbe::setSegments(ball, static_cast<int>(state.param()));
+
+    double angle = 0.0;
+    while (state.keepRunning()) {
+        angle += 0.7;
+        if (angle >= 360.0) angle -= 360.0;
+        Keruis::Bench::doNotOptimize(FloatingBallProbe::hovered(ball, angle));
+    }
+}
+
+// param 为每层的子项数，菜单固定 4 层并沿最后一个子项展开到底
+KERUIS_BENCH("FloatingBall/generateMenuLayers", {4, 8, 16}) {
+    FloatingBall& ball = FloatingBallProbe::ball();
+    FloatingBallProbe::setMenu(ball, static_cast<int>(state.param()), 4);
+
+    while (state.keepRunning()) {
+        FloatingBallProbe::generateMenuLayers(ball);
+        Keruis::Bench::doNotOptimize(FloatingBallProbe::menuLayerCount(ball));
+    }
+}
+
+// param 为每层的子项数，菜单 2 级，每一层都有使用记录（按使用频率排序）；在第 0 层中轮流选中各条目，
+// 只更新外层的视图，不复制标签也不分配内存。各子菜单的顺序在计时前计算一次；计数 allocs_per_iter 为每次选中的 operator new 次数
+KERUIS_BENCH("FloatingBall/selectMenuItem", {10, 1000}) {
+    FloatingBall& ball = FloatingBallProbe::ball();
+    const int items = static_cast<int>(state.param());
+    FloatingBallProbe::setMenu(ball, items, 2);
+    for (int i = 0; i < items; ++i) FloatingBallProbe::recordUsage(ball, {i, items - 1 - i});
+    FloatingBallProbe::generateMenuLayers(ball);
+    for (int i = 0; i < items; ++i) FloatingBallProbe::select(ball, 0, i);
+
+    int item = 0;
+    const std::size_t allocations = Keruis::Bench::allocations();
+    while (state.keepRunning()) {
+        item = (item + 1) % items;
+        FloatingBallProbe::select(ball, 0, item);
+        Keruis::Bench::doNotOptimize(FloatingBallProbe::menuLayerCount(ball));
+    }
+    state.counter("allocs_per_iter", static_cast<double>(Keruis::Bench::allocations() - allocations) / static_cast<double>(state.iterations()));
+}
+
+// param 为第 0 层的条目数（单级菜单），窗口位于中间；每帧只绘制可见的扇区，耗时应与条目数无关
+KERUIS_BENCH("FloatingBall/pagedMenuFrame", {8, 1000, 100000}) {
+    FloatingBall& ball = FloatingBallProbe::ball();
+    const int items = static_cast<int>(state.param());
+    FloatingBallProbe::setMenu(ball, items, 1);
+    FloatingBallProbe::apply(ball, FloatingBallProbe::State::RadialMenu);
+    FloatingBallProbe::scroll(ball, 0, items / 2);
+
+    QImage image(ball.size(), QImage::Format_ARGB32_Premultiplied);
+    while (state.keepRunning()) {
+        image.fill(Qt::transparent);
+        ball.render(&image, QPoint(), QRegion(), QWidget::DrawChildren);
+        Keruis::Bench::doNotOptimize(image.constBits());
+    }
+}
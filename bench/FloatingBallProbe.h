@@ -0,0 +1,221 @@
+#ifndef FLOATINGBALLPROBE_H
+#define FLOATINGBALLPROBE_H
+
+#include <string>
+#include <vector>
+
+#include <QApplication>
+
+#include "../src/FloatingBall/FloatingBall.h"
+
+// 基准与渲染工具访问 FloatingBall 私有成员的入口（FloatingBall 中声明为 friend）
+struct FloatingBallProbe {
+    enum class State {
+        Idle,
+        Hovered,
+        Dragging,
+        RadialMenu,
+        DockedLeft,
+        DockedRight,
+        DockedTop,
+        DockedBottom
+    };
+
+    static constexpr State AllStates[] = {
+        State::Idle, State::Hovered, State::Dragging, State::RadialMenu,
+        State::DockedLeft, State::DockedRight, State::DockedTop, State::DockedBottom
+    };
+
+    static const char* name(State state) {
+        switch (state) {
+            case State::Idle:         return "idle";
+            case State::Hovered:      return "hovered";
+            case State::Dragging:     return "dragging";
+            case State::RadialMenu:   return "radialMenu";
+            case State::DockedLeft:   return "dockedLeft";
+            case State::DockedRight:  return "dockedRight";
+            case State::DockedTop:    return "dockedTop";
+            case State::DockedBottom: return "dockedBottom";
+        }
+        return "?";
+    }
+
+    // 无显示环境时使用 offscreen 平台，整个进程只创建一次 QApplication
+    static void ensureApplication() {
+        static int argc = 1;
+        static char appName[] = "KeruisUtils";
+        static char* argv[] = {appName, nullptr};
+        if (!QApplication::instance()) {
+            if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+            static QApplication app(argc, argv);
+        }
+    }
+
+    // 不读取也不写入使用记录，菜单始终按原顺序显示
+    static FloatingBall& ball() {
+        ensureApplication();
+        if (qEnvironmentVariableIsEmpty("KERUIS_USAGE")) qputenv("KERUIS_USAGE", "0");
+        static FloatingBall instance;
+        return instance;
+    }
+
+    // 把 ball 直接置于某个状态的终态（不经过动画），窗口中心固定在 (100 + 379, 100 + 379)，拖尾不随时间过期，保证输出可复现；
+    // 窗口尺寸随后按该状态的内容收缩，所以各状态的图像尺寸不同
+    static void apply(FloatingBall& b, State state) {
+        reset(b);
+
+        switch (state) {
+            case State::Idle:
+                break;
+            case State::Hovered:
+                b.m_selected = true;
+                b.m_eyeOpenProgress = -0.8f;
+                break;
+            case State::Dragging: {
+                b.m_selected = true;
+                b.m_isDragging = true;
+                b.m_eyeOpenProgress = -0.8f;
+                b.m_jellyOffset = QPointF(24.0, -12.0);
+
+                // 从左下方以弧线拖到当前位置，节点数 = 容量
+                const QPointF center = b.mapToGlobal(b.rect().center());
+                const auto nodes = static_cast<int>(b.m_trail.capacity());
+                for (int i = 0; i < nodes; ++i) {
+                    const double t = 1.0 - static_cast<double>(i) / (nodes - 1);
+                    b.m_trail.addPoint(center + QPointF(-260.0 * t, 180.0 * t * t), 1.0f);
+                }
+                break;
+            }
+            case State::RadialMenu:
+                b.m_ballShrinkProgress = 0.0;
+                b.m_showSegments = true;
+                b.m_expanded = true;
+                b.m_expandedLayerCount = b.layerCount();
+                b.m_layout.resetAnimation(true);
+                b.m_selectedSegments = {1, 2, 0, -1};
+                b.generateMenuLayers();
+                b.m_hoveredLayer = b.layerCount() - 1;
+                b.m_hoveredIndex = 2;
+                break;
+            case State::DockedLeft:   b.m_dockDirection = FloatingBall::DockDirection::Left;   break;
+            case State::DockedRight:  b.m_dockDirection = FloatingBall::DockDirection::Right;  break;
+            case State::DockedTop:    b.m_dockDirection = FloatingBall::DockDirection::Top;    break;
+            case State::DockedBottom: b.m_dockDirection = FloatingBall::DockDirection::Bottom; break;
+        }
+
+        b.updateWindowExtent();
+    }
+
+    static void reset(FloatingBall& b) {
+        b.setWindowExtent(FloatingBall::MaxWindowExtent);
+        b.move(100, 100);
+        b.updateCenterPosition();
+
+        b.m_selected = false;
+        b.m_isDragging = false;
+        b.m_expanded = false;
+        b.m_showSegments = false;
+        b.m_ballShrinkProgress = 1.0;
+        b.m_eyeOpenProgress = 1.0f;
+        b.m_jellyOffset = QPointF();
+        b.m_dockDirection = FloatingBall::DockDirection::None;
+        b.m_expandedLayerCount = 0;
+        b.m_hoveredLayer = -1;
+        b.m_hoveredIndex = -1;
+        b.m_selectedSegments.clear();
+        b.m_menuDepth = 0;
+        b.m_searchQuery.clear();
+        b.m_searchResults.reset();
+        b.resetItemOrders();
+        b.m_prefetchLayer = -1;
+        b.m_prefetchOrder.reset();
+        b.m_layout.resetAnimation(false);
+        for (int layer = 0; layer < b.layerCount(); ++layer) b.m_layout[layer].firstItem = 0;
+        b.generateMenuLayers();
+
+        b.m_trail.clear();
+        b.m_trail.setResampling({});
+    }
+
+    // ======= 基准用 =======
+
+    // 第 0 层设为 segments 个扇区；扇区数较多时间隔取 0，保证每个扇区的跨度为正
+    static void setSegments(FloatingBall& b, int segments) {
+        b.m_layout.setSegments(0, segments, segments > 36 ? 0 : 5);
+    }
+
+    static int hovered(const FloatingBall& b, double angle) {
+        return b.getHoveredSegmentFromAngle(0, angle);
+    }
+
+    // 生成每层 branching 个子项、共 depth 层的菜单，并沿最后一个子项选中到底；使用记录清空
+    static void setMenu(FloatingBall& b, int branching, int depth) {
+        b.m_menu = std::make_shared<const MenuTree>(FloatingBall::TESTgenerateMenu(std::vector<int>(depth, branching)));
+        b.m_selectedSegments.assign(depth, branching - 1);
+        b.m_usage = UsageStore();
+        b.resetItemOrders();
+    }
+
+    // 与选中 path（每一级的子项下标）相同的使用记录，不写文件
+    static void recordUsage(FloatingBall& b, const std::vector<int>& path) {
+        MenuTree::Index node = MenuTree::Root;
+        UsageStore::Key key = UsageStore::RootKey;
+        for (const int item : path) {
+            const MenuTree::Index parent = node;
+            const UsageStore::Key parentKey = key;
+            node = b.m_menu->child(parent, item);
+            if (node == MenuTree::Root) return;
+
+            key = UsageStore::childKey(parentKey, b.m_menu->label(node));
+            b.m_usage.record(key, UsageStore::Epoch);
+            b.refreshItemOrder(parent, parentKey);
+        }
+    }
+
+    // 标签字体（默认 Arial 10pt，由系统字体匹配）；后台绘制线程的 renderer 不受影响，所以同时改为在 GUI 线程绘制
+    static void setLabelFont(FloatingBall& b, const QFont& font) {
+        b.setRenderThreadEnabled(false);
+        b.m_renderer.setLabelFont(font);
+    }
+
+    static QFont labelFont(const FloatingBall& b) {
+        return b.m_renderer.labelFont();
+    }
+
+    static MenuTree generateMenu(const std::vector<int>& branchingPerLevel) {
+        return FloatingBall::TESTgenerateMenu(branchingPerLevel);
+    }
+
+    static void generateMenuLayers(FloatingBall& b) {
+        b.generateMenuLayers();
+    }
+
+    // 第 layer 层的条目窗口移动 delta 个条目
+    static void scroll(FloatingBall& b, int layer, int delta) {
+        b.m_layout.scroll(layer, delta);
+    }
+
+    // 与点击第 layer 层的第 item 个条目相同的菜单层更新
+    static void select(FloatingBall& b, int layer, int item) {
+        b.m_selectedSegments[b.m_menuDepth + layer] = item;
+        b.updateMenuLayers(layer);
+    }
+
+    static std::size_t menuLayerCount(const FloatingBall& b) {
+        return b.m_menuLevels.size();
+    }
+
+    // ======= 重绘面积测量用 =======
+
+    // false 时每次重绘整个窗口，与 KERUIS_DAMAGE=0 相同
+    static void setDamageTracking(FloatingBall& b, bool enabled) {
+        b.m_damageTracking = enabled;
+    }
+
+    // 第 layer 层完全展开时扇区环的中线半径，悬停沿该半径扫过这一层的所有扇区
+    static double ringMidRadius(const FloatingBall& b, int layer) {
+        return (b.m_layout.restingInnerRadius(layer, b.m_innerRadius) + b.m_layout[layer].radius) / 2.0;
+    }
+};
+
+#endif //FLOATINGBALLPROBE_H
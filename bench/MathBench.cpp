@@ -0,0 +1,183 @@
+#include "Bench.h"
+
+#include <cmath>
+#include <span>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+#include <QPointF>
+
+#include "../src/ext/math/math.h"
+
+// param 为每次迭代处理的元素个数；std 版本作为对照
+namespace {
+
+    using namespace Keruis::Math;
+
+    std::vector<float> makeInput(std::size_t n, float lo, float hi, std::uint32_t seed = 42) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(lo, hi);
+        std::vector<float> values(n);
+        for (auto& v : values) v = dist(rng);
+        return values;
+    }
+
+    template <typename Fn_>
+    void unary(Keruis::Bench::State& state, float lo, float hi, Fn_ fn) {
+        const std::vector<float> in = makeInput(state.param(), lo, hi);
+        std::vector<float> out(in.size());
+
+        while (state.keepRunning()) {
+            for (std::size_t i = 0; i < in.size(); ++i) out[i] = fn(in[i]);
+            Keruis::Bench::doNotOptimize(out.data());
+        }
+    }
+
+    template <typename Fn_>
+    void binary(Keruis::Bench::State& state, float lo, float hi, Fn_ fn) {
+        const std::vector<float> a = makeInput(state.param(), lo, hi);
+        const std::vector<float> b = makeInput(state.param(), lo, hi, 7);
+        std::vector<float> out(a.size());
+
+        while (state.keepRunning()) {
+            for (std::size_t i = 0; i < a.size(); ++i) out[i] = fn(a[i], b[i]);
+            Keruis::Bench::doNotOptimize(out.data());
+        }
+    }
+
+    template <typename Fn_>
+    void batchUnary(Keruis::Bench::State& state, float lo, float hi, Fn_ fn) {
+        const std::vector<float> in = makeInput(state.param(), lo, hi);
+        std::vector<float> out(in.size());
+
+        while (state.keepRunning()) {
+            fn(std::span<const float>(in), std::span<float>(out));
+            Keruis::Bench::doNotOptimize(out.data());
+        }
+    }
+
+    template <typename Fn_>
+    void batchBinary(Keruis::Bench::State& state, float lo, float hi, Fn_ fn) {
+        const std::vector<float> a = makeInput(state.param(), lo, hi);
+        const std::vector<float> b = makeInput(state.param(), -hi, -lo);
+        std::vector<float> out(a.size());
+
+        while (state.keepRunning()) {
+            fn(std::span<const float>(a), std::span<const float>(b), std::span<float>(out));
+            Keruis::Bench::doNotOptimize(out.data());
+        }
+    }
+
+    Vec2Buffer makePoints(std::size_t n, std::uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(0.0f, 760.0f);
+        Vec2Buffer points(n);
+        for (std::size_t i = 0; i < n; ++i) points.span().set(i, {dist(rng), dist(rng)});
+        return points;
+    }
+
+    constexpr float Angle = 64.0f;
+
+}
+
+#define MATH_BENCH_SIZES {64, 1024, 16384}
+
+// ======= 标量 =======
+
+KERUIS_BENCH("Math/std::sin", MATH_BENCH_SIZES)      { unary(state, -Angle, Angle, [](float x) { return std::sin(x); }); }
+KERUIS_BENCH("Math/fast_sin<Low>", MATH_BENCH_SIZES)    { unary(state, -Angle, Angle, [](float x) { return fast_sin<Precision::Low>(x); }); }
+KERUIS_BENCH("Math/fast_sin<Medium>", MATH_BENCH_SIZES) { unary(state, -Angle, Angle, [](float x) { return fast_sin<Precision::Medium>(x); }); }
+KERUIS_BENCH("Math/fast_sin<High>", MATH_BENCH_SIZES)   { unary(state, -Angle, Angle, [](float x) { return fast_sin<Precision::High>(x); }); }
+
+KERUIS_BENCH("Math/std::cos", MATH_BENCH_SIZES)      { unary(state, -Angle, Angle, [](float x) { return std::cos(x); }); }
+KERUIS_BENCH("Math/fast_cos<Low>", MATH_BENCH_SIZES)    { unary(state, -Angle, Angle, [](float x) { return fast_cos<Precision::Low>(x); }); }
+KERUIS_BENCH("Math/fast_cos<Medium>", MATH_BENCH_SIZES) { unary(state, -Angle, Angle, [](float x) { return fast_cos<Precision::Medium>(x); }); }
+KERUIS_BENCH("Math/fast_cos<High>", MATH_BENCH_SIZES)   { unary(state, -Angle, Angle, [](float x) { return fast_cos<Precision::High>(x); }); }
+
+KERUIS_BENCH("Math/std::atan2", MATH_BENCH_SIZES)      { binary(state, -400.0f, 400.0f, [](float y, float x) { return std::atan2(y, x); }); }
+KERUIS_BENCH("Math/fast_atan2<Low>", MATH_BENCH_SIZES)    { binary(state, -400.0f, 400.0f, [](float y, float x) { return fast_atan2<Precision::Low>(y, x); }); }
+KERUIS_BENCH("Math/fast_atan2<Medium>", MATH_BENCH_SIZES) { binary(state, -400.0f, 400.0f, [](float y, float x) { return fast_atan2<Precision::Medium>(y, x); }); }
+KERUIS_BENCH("Math/fast_atan2<High>", MATH_BENCH_SIZES)   { binary(state, -400.0f, 400.0f, [](float y, float x) { return fast_atan2<Precision::High>(y, x); }); }
+
+KERUIS_BENCH("Math/std::sqrt", MATH_BENCH_SIZES)      { unary(state, 0.0f, 1e6f, [](float x) { return std::sqrt(x); }); }
+KERUIS_BENCH("Math/fast_sqrt<Low>", MATH_BENCH_SIZES)    { unary(state, 0.0f, 1e6f, [](float x) { return fast_sqrt<Precision::Low>(x); }); }
+KERUIS_BENCH("Math/fast_sqrt<Medium>", MATH_BENCH_SIZES) { unary(state, 0.0f, 1e6f, [](float x) { return fast_sqrt<Precision::Medium>(x); }); }
+KERUIS_BENCH("Math/fast_sqrt<High>", MATH_BENCH_SIZES)   { unary(state, 0.0f, 1e6f, [](float x) { return fast_sqrt<Precision::High>(x); }); }
+
+KERUIS_BENCH("Math/std::hypot", MATH_BENCH_SIZES)      { binary(state, -400.0f, 400.0f, [](float x, float y) { return std::hypot(x, y); }); }
+KERUIS_BENCH("Math/fast_hypot<Low>", MATH_BENCH_SIZES)    { binary(state, -400.0f, 400.0f, [](float x, float y) { return fast_hypot<Precision::Low>(x, y); }); }
+KERUIS_BENCH("Math/fast_hypot<Medium>", MATH_BENCH_SIZES) { binary(state, -400.0f, 400.0f, [](float x, float y) { return fast_hypot<Precision::Medium>(x, y); }); }
+KERUIS_BENCH("Math/fast_hypot<High>", MATH_BENCH_SIZES)   { binary(state, -400.0f, 400.0f, [](float x, float y) { return fast_hypot<Precision::High>(x, y); }); }
+
+KERUIS_BENCH("Math/curve", MATH_BENCH_SIZES) { unary(state, -0.5f, 1.0f, [](float x) { return curve(x, 0.0f, 0.5f); }); }
+
+KERUIS_BENCH("Math/from_polar_rad<QPointF>", MATH_BENCH_SIZES) {
+    unary(state, -Angle, Angle, [](float a) { return static_cast<float>(from_polar_rad<QPointF>(a, 10.0f).x()); });
+}
+
+KERUIS_BENCH("Math/equals<QPointF>", MATH_BENCH_SIZES) {
+    binary(state, 0.0f, 760.0f, [](float x, float y) { return equals(QPointF(x, y), QPointF(380.0, 380.0), 40.0f) ? 1.0f : 0.0f; });
+}
+
+// ======= 批量 =======
+
+KERUIS_BENCH("Math/fast_sin[batch]", MATH_BENCH_SIZES) {
+    batchUnary(state, -Angle, Angle, [](std::span<const float> in, std::span<float> out) { fast_sin<Precision::High>(in, out); });
+}
+KERUIS_BENCH("Math/fast_cos[batch]", MATH_BENCH_SIZES) {
+    batchUnary(state, -Angle, Angle, [](std::span<const float> in, std::span<float> out) { fast_cos<Precision::High>(in, out); });
+}
+KERUIS_BENCH("Math/fast_sqrt[batch]", MATH_BENCH_SIZES) {
+    batchUnary(state, 0.0f, 1e6f, [](std::span<const float> in, std::span<float> out) { fast_sqrt<Precision::High>(in, out); });
+}
+KERUIS_BENCH("Math/fast_atan2[batch]", MATH_BENCH_SIZES) {
+    batchBinary(state, 1.0f, 400.0f, [](std::span<const float> y, std::span<const float> x, std::span<float> out) { fast_atan2<Precision::High>(y, x, out); });
+}
+KERUIS_BENCH("Math/fast_hypot[batch]", MATH_BENCH_SIZES) {
+    batchBinary(state, 1.0f, 400.0f, [](std::span<const float> x, std::span<const float> y, std::span<float> out) { fast_hypot<Precision::High>(x, y, out); });
+}
+
+KERUIS_BENCH("Math/Vec2::lerp[batch]", MATH_BENCH_SIZES) {
+    const Vec2Buffer a = makePoints(state.param(), 1);
+    const Vec2Buffer b = makePoints(state.param(), 2);
+    Vec2Buffer out(state.param());
+
+    while (state.keepRunning()) {
+        lerp(a, b, 0.25f, out);
+        Keruis::Bench::doNotOptimize(out.span().x().data());
+    }
+}
+
+KERUIS_BENCH("Math/Vec2::distance[batch]", MATH_BENCH_SIZES) {
+    const Vec2Buffer a = makePoints(state.param(), 1);
+    std::vector<float> out(state.param());
+
+    while (state.keepRunning()) {
+        distance(a, Vec2{380.0f, 380.0f}, out);
+        Keruis::Bench::doNotOptimize(out.data());
+    }
+}
+
+KERUIS_BENCH("Math/Vec2::equals[batch]", MATH_BENCH_SIZES) {
+    const Vec2Buffer a = makePoints(state.param(), 1);
+    std::vector<std::uint8_t> out(state.param());
+
+    std::size_t hits = 0;
+    while (state.keepRunning()) {
+        hits = equals(a, Vec2{380.0f, 380.0f}, 40.0f, out);
+        Keruis::Bench::doNotOptimize(hits);
+    }
+    state.counter("hits", static_cast<double>(hits));
+}
+
+KERUIS_BENCH("Math/Vec2::from_polar_rad[batch]", MATH_BENCH_SIZES) {
+    const std::vector<float> angle = makeInput(state.param(), -Angle, Angle);
+    const std::vector<float> length = makeInput(state.param(), 0.0f, 100.0f, 7);
+    Vec2Buffer out(state.param());
+
+    while (state.keepRunning()) {
+        from_polar_rad<Precision::High>(angle, length, out);
+        Keruis::Bench::doNotOptimize(out.span().x().data());
+    }
+}
@@ -0,0 +1,207 @@
+#include "Bench.h"
+
+#include <array>
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include <QFile>
+#include <QDir>
+
+#include "FloatingBallProbe.h"
+#include "../src/core/menu/MenuFile.h"
+#include "../src/core/menu/MenuSearch.h"
+#include "../src/core/menu/UsageStore.h"
+
+namespace {
+
+    // 扁平化之前的菜单结构与生成方式：子节点按值保存，每一级都把整棵子树复制进父节点
+    struct LegacyMenuNode {
+        std::string label;
+        std::vector<LegacyMenuNode> children;
+
+        LegacyMenuNode(const std::string& label, const std::vector<LegacyMenuNode>& children) : label(label), children(children) {}
+    };
+
+    std::vector<LegacyMenuNode> legacyGenerateMenu(const std::vector<int>& branchingPerLevel, int depth, const std::string& prefix) {
+        std::vector<LegacyMenuNode> nodes;
+
+        if (depth >= branchingPerLevel.size())
+            return nodes;
+
+        int branchingFactor = branchingPerLevel[depth];
+
+        for (int i = 0; i < branchingFactor; ++i) {
+            std::string label;
+
+            if (prefix.empty()) {
+                label = std::string(1, 'A' + i);
+            } else if (depth + 1 == branchingPerLevel.size()) {
+                label = prefix + std::to_string(i + 1);
+            } else if (std::isdigit(prefix.back())) {
+                label = prefix + static_cast<char>('a' + i);
+            } else {
+                label = prefix + std::to_string(i + 1);
+            }
+
+            auto children = legacyGenerateMenu(branchingPerLevel, depth + 1, label);
+            nodes.emplace_back(label, children);
+        }
+
+        return nodes;
+    }
+
+    // 与 MenuTree::memoryUsage 同口径的堆内存估计：vector 的容量 + 超出 SSO 的字符串
+    std::size_t legacyMemoryUsage(const std::vector<LegacyMenuNode>& nodes) {
+        std::size_t bytes = nodes.capacity() * sizeof(LegacyMenuNode);
+        for (const auto& node : nodes) {
+            if (node.label.capacity() > std::string().capacity()) bytes += node.label.capacity() + 1;
+            bytes += legacyMemoryUsage(node.children);
+        }
+        return bytes;
+    }
+
+    // 常驻内存（字节），只在 Linux 上可用，其余平台返回 0
+    double residentBytes() {
+#if defined(__linux__)
+        if (std::FILE* file = std::fopen("/proc/self/statm", "r")) {
+            long size = 0, resident = 0;
+            const int read = std::fscanf(file, "%ld %ld", &size, &resident);
+            std::fclose(file);
+            if (read == 2) return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE));
+        }
+#endif
+        return 0.0;
+    }
+
+    // param 约等于节点数：每级 10 个子项，共 log10(param) 级
+    std::vector<int> branchingFor(std::size_t nodes) {
+        const auto depth = static_cast<int>(std::lround(std::log10(static_cast<double>(nodes))));
+        return std::vector<int>(depth, 10);
+    }
+
+}
+
+// 构建耗时；计数 nodes、heap_bytes（结构自身的堆内存估计）、rss_bytes（构建前后常驻内存之差，仅 Linux）
+KERUIS_BENCH("MenuTree/build", {10000, 1000000}) {
+    const std::vector<int> branching = branchingFor(state.param());
+
+    const double rssBefore = residentBytes();
+    {
+        const MenuTree tree = FloatingBallProbe::generateMenu(branching);
+        state.counter("nodes", static_cast<double>(tree.size()));
+        state.counter("heap_bytes", static_cast<double>(tree.memoryUsage()));
+        state.counter("rss_bytes", residentBytes() - rssBefore);
+    }
+
+    while (state.keepRunning()) {
+        const MenuTree tree = FloatingBallProbe::generateMenu(branching);
+        Keruis::Bench::doNotOptimize(tree.size());
+    }
+}
+
+KERUIS_BENCH("MenuTree/buildLegacy", {10000, 1000000}) {
+    const std::vector<int> branching = branchingFor(state.param());
+
+    const double rssBefore = residentBytes();
+    {
+        const std::vector<LegacyMenuNode> roots = legacyGenerateMenu(branching, 0, "");
+        state.counter("heap_bytes", static_cast<double>(legacyMemoryUsage(roots)));
+        state.counter("rss_bytes", residentBytes() - rssBefore);
+    }
+
+    while (state.keepRunning()) {
+        const std::vector<LegacyMenuNode> roots = legacyGenerateMenu(branching, 0, "");
+        Keruis::Bench::doNotOptimize(roots.size());
+    }
+}
+
+// 映射编译后的菜单：只读取并校验文件头，耗时应与节点数无关；计数 file_bytes 为编译文件的大小
+KERUIS_BENCH("MenuFile/map", {10000, 1000000}) {
+    const QString path = QDir::temp().filePath(QStringLiteral("keruis-bench-%1.kmenu").arg(state.param()));
+    {
+        const QByteArray image = MenuFile::compile(FloatingBallProbe::generateMenu(branchingFor(state.param())));
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(image) != image.size()) return;
+        state.counter("file_bytes", static_cast<double>(image.size()));
+    }
+
+    while (state.keepRunning()) {
+        const std::shared_ptr<const MenuTree> tree = MenuFile::map(path);
+        Keruis::Bench::doNotOptimize(tree.get());
+    }
+
+    QFile::remove(path);
+}
+
+// 建立 n-gram 索引（展开菜单时在后台进行）；计数 nodes
+KERUIS_BENCH("MenuSearch/build", {10000, 100000}) {
+    const auto tree = std::make_shared<const MenuTree>(FloatingBallProbe::generateMenu(branchingFor(state.param())));
+    state.counter("nodes", static_cast<double>(tree->size()));
+
+    while (state.keepRunning()) {
+        const MenuSearch search(tree);
+        Keruis::Bench::doNotOptimize(search.tree().get());
+    }
+}
+
+// 逐键输入一个标签的全部前缀（每次迭代从空查询开始）；计数 scanned 为最后一个键检查过的候选数
+KERUIS_BENCH("MenuSearch/query", {10000, 100000}) {
+    const auto tree = std::make_shared<const MenuTree>(FloatingBallProbe::generateMenu(branchingFor(state.param())));
+    MenuSearch search(tree);
+
+    const std::string_view label = tree->label(static_cast<MenuTree::Index>(tree->size()));
+    search.search(label, 256);
+    state.counter("scanned", static_cast<double>(search.scanned()));
+
+    while (state.keepRunning()) {
+        search.search({}, 0);
+        for (std::size_t n = 1; n <= label.size(); ++n) {
+            Keruis::Bench::doNotOptimize(search.search(label.substr(0, n), 256).size());
+        }
+    }
+}
+
+// 最坏的单字符查询：出现在最多标签中的字符，每次迭代从空查询开始；计数 matches 为含有该字符的节点数
+KERUIS_BENCH("MenuSearch/query1", {10000, 100000}) {
+    const auto tree = std::make_shared<const MenuTree>(FloatingBallProbe::generateMenu(branchingFor(state.param())));
+    MenuSearch search(tree);
+
+    std::array<std::size_t, 256> counts{};
+    for (MenuTree::Index node = 1; node <= tree->size(); ++node) {
+        std::array<bool, 256> seen{};
+        for (const char c : tree->label(node)) seen[static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)))] = true;
+        for (std::size_t c = 0; c < seen.size(); ++c) counts[c] += seen[c];
+    }
+    const auto worst = static_cast<char>(std::ranges::max_element(counts) - counts.begin());
+    state.counter("matches", static_cast<double>(counts[static_cast<unsigned char>(worst)]));
+
+    while (state.keepRunning()) {
+        search.search({}, 0);
+        Keruis::Bench::doNotOptimize(search.search(std::string_view(&worst, 1), 256).size());
+    }
+}
+
+// 按使用频率排列一层的条目：param 为子项数（单级菜单），每 10 个子项中有 1 个有记录；
+// 菜单层按父节点缓存顺序，这里是缓存未命中（生成新的子菜单层）时的耗时
+KERUIS_BENCH("UsageStore/order", {10, 1000, 100000}) {
+    const MenuTree tree = FloatingBallProbe::generateMenu({static_cast<int>(state.param())});
+    UsageStore usage;
+    const std::span<const MenuTree::Node> items = tree.children(MenuTree::Root);
+    for (std::size_t i = 0; i < items.size(); i += 10) {
+        usage.record(UsageStore::childKey(UsageStore::RootKey, tree.label(items[i])), UsageStore::Epoch + static_cast<std::int64_t>(i));
+    }
+    state.counter("entries", static_cast<double>(usage.size()));
+
+    while (state.keepRunning()) {
+        const std::shared_ptr<const UsageStore::Order> order = usage.order(tree, MenuTree::Root, UsageStore::RootKey);
+        Keruis::Bench::doNotOptimize(order.get());
+    }
+}
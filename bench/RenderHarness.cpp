@@ -0,0 +1,383 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <numbers>
+#include <algorithm>
+
+#include <QDir>
+#include <QFont>
+#include <QImage>
+#include <QTimer>
+#include <QFontInfo>
+#include <QEventLoop>
+#include <QMouseEvent>
+#include <QEnterEvent>
+#include <QElapsedTimer>
+#include <QFontDatabase>
+#include <QCoreApplication>
+
+#include "FloatingBallProbe.h"
+
+// 用法：KeruisUtilsRender [--frames <n>] [--golden <目录>] [--update] [--tolerance <n>] [--out <目录>] [--json <文件|->] [--font <字体文件>]
+//       KeruisUtilsRender --damage
+//
+// 在 offscreen 平台下把 FloatingBall 依次置于各个状态，每个状态渲染 frames 次到 QImage，报告单帧绘制耗时的分位数。
+//   --golden     与 <目录>/<状态>.png 逐像素比较，任一通道差值超过 tolerance 的像素计为不同；有不同或缺失时返回 1
+//   --update     把当前输出写为新的基准图（需同时给出 --golden）
+//   --out        把当前输出写到 <目录>/<状态>.png，与基准不同时另写 <状态>.diff.png（不同的像素标为红色）
+//   --font       用该字体文件（.ttf / .otf）绘制标签，而不是由系统按 "Arial" 匹配到的字体
+//
+// 仓库不附带基准图：文字经由字体栅格化，radialMenu 的输出取决于匹配到的字体、FreeType 版本与 DPI，
+// 在一台机器上生成的基准图换一台机器往往逐像素不同。要得到可复现的基准图，生成与比较时固定以下条件：
+//   - 字体：--font 指定随基准图一起保存的字体文件（例如 DejaVuSans.ttf），标签不再依赖系统字体；
+//     也可以设置 QT_QPA_FONTDIR 指向只含该字体的目录（offscreen 平台在未使用 fontconfig 时从这里加载字体）
+//   - 缩放：QT_SCALE_FACTOR=1，且不设置 QT_SCREEN_SCALE_FACTORS，保证设备像素比为 1
+//   - 平台：QT_QPA_PLATFORM=offscreen（未设置时本工具自动使用），不设置 KERUIS_RENDER_THREAD
+//   - 同一 Qt 版本（栅格化与抗锯齿的实现随版本变化）
+// 例如：
+//   QT_SCALE_FACTOR=1 KeruisUtilsRender --font fonts/DejaVuSans.ttf --golden goldens --update
+//   QT_SCALE_FACTOR=1 KeruisUtilsRender --font fonts/DejaVuSans.ttf --golden goldens --tolerance 2
+// 固定以上条件后机器之间剩下的少量抗锯齿差异用 --tolerance（例如 2）容忍。
+//
+// --damage 不渲染各个状态，而是显示窗口并以 125 Hz 的鼠标事件回放同一段交互（进入 → 拖动一圈 → 松开 →
+// 右键展开菜单并沿第 0 层扫过所有扇区 → 右键收起 → 离开），先按区域重绘、再每次重绘整个窗口（与 KERUIS_DAMAGE=0 相同），
+// 各运行一次，报告帧数、平均每帧与每秒重绘的像素数（paintEvent 的重绘区域面积，逻辑像素）。
+// 两次运行的交互与时长相同，所以比值就是按区域重绘减少的重绘面积。
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        int         frames    = 200;
+        int         tolerance = 0;
+        bool        update    = false;
+        std::string goldenDir;
+        std::string outDir;
+        std::string jsonPath;
+        std::string fontPath;
+        bool        damage    = false;
+    };
+
+    struct Comparison {
+        bool        compared  = false;
+        bool        missing   = false;
+        long long   diffCount = 0;
+        int         maxDiff   = 0;
+    };
+
+    struct StateResult {
+        std::string name;
+        double      p50Us = 0.0;
+        double      p90Us = 0.0;
+        double      p99Us = 0.0;
+        double      maxUs = 0.0;
+        Comparison  comparison;
+    };
+
+    QImage render(FloatingBall& ball) {
+        QImage image(ball.size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        ball.render(&image, QPoint(), QRegion(), QWidget::DrawChildren);
+        return image;
+    }
+
+    double percentile(const std::vector<double>& sorted, double p) {
+        const auto index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    Comparison compare(const QImage& actual, const QImage& golden, int tolerance, QImage* diff) {
+        Comparison result;
+        result.compared = true;
+
+        if (golden.size() != actual.size()) {
+            result.diffCount = static_cast<long long>(actual.width()) * actual.height();
+            result.maxDiff = 255;
+            return result;
+        }
+
+        const QImage expected = golden.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        if (diff) {
+            *diff = QImage(actual.size(), QImage::Format_ARGB32_Premultiplied);
+            diff->fill(Qt::transparent);
+        }
+
+        for (int y = 0; y < actual.height(); ++y) {
+            const auto* a = reinterpret_cast<const QRgb*>(actual.constScanLine(y));
+            const auto* e = reinterpret_cast<const QRgb*>(expected.constScanLine(y));
+            for (int x = 0; x < actual.width(); ++x) {
+                const int d = std::max({std::abs(qRed(a[x])   - qRed(e[x])),
+                                        std::abs(qGreen(a[x]) - qGreen(e[x])),
+                                        std::abs(qBlue(a[x])  - qBlue(e[x])),
+                                        std::abs(qAlpha(a[x]) - qAlpha(e[x]))});
+                result.maxDiff = std::max(result.maxDiff, d);
+                if (d > tolerance) {
+                    ++result.diffCount;
+                    if (diff) diff->setPixel(x, y, qRgba(255, 0, 0, 255));
+                }
+            }
+        }
+        return result;
+    }
+
+    StateResult run(FloatingBall& ball, FloatingBallProbe::State state, const Options& options) {
+        StateResult result;
+        result.name = FloatingBallProbe::name(state);
+
+        FloatingBallProbe::apply(ball, state);
+        QImage image = render(ball);
+
+        std::vector<double> samples;
+        samples.reserve(options.frames);
+        for (int i = 0; i < options.frames; ++i) {
+            const auto start = Clock::now();
+            image = render(ball);
+            samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        std::ranges::sort(samples);
+        result.p50Us = percentile(samples, 0.50);
+        result.p90Us = percentile(samples, 0.90);
+        result.p99Us = percentile(samples, 0.99);
+        result.maxUs = samples.back();
+
+        const QString file = QString::fromStdString(result.name) + ".png";
+        if (!options.goldenDir.empty()) {
+            const QDir golden(QString::fromStdString(options.goldenDir));
+            if (options.update) {
+                golden.mkpath(".");
+                image.save(golden.filePath(file));
+            } else {
+                const QImage expected(golden.filePath(file));
+                if (expected.isNull()) {
+                    result.comparison.compared = true;
+                    result.comparison.missing = true;
+                } else {
+                    QImage diff;
+                    result.comparison = compare(image, expected, options.tolerance, options.outDir.empty() ? nullptr : &diff);
+                    if (result.comparison.diffCount > 0 && !options.outDir.empty()) {
+                        diff.save(QDir(QString::fromStdString(options.outDir)).filePath(QString::fromStdString(result.name) + ".diff.png"));
+                    }
+                }
+            }
+        }
+
+        if (!options.outDir.empty()) {
+            image.save(QDir(QString::fromStdString(options.outDir)).filePath(file));
+        }
+        return result;
+    }
+
+    // ======= --damage =======
+
+    struct DamageResult {
+        double        seconds = 0.0;
+        std::uint64_t frames  = 0;
+        std::uint64_t pixels  = 0;
+    };
+
+    constexpr int    InputIntervalMs = 8;     // 125 Hz 鼠标
+    constexpr int    SweepSteps      = 250;   // 拖动与悬停各扫一圈，约 2 秒
+    constexpr double DragRadius      = 100.0;
+
+    // 运行事件循环 ms 毫秒，期间动画、重绘照常进行
+    void wait(int ms) {
+        QEventLoop loop;
+        QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    void mouse(FloatingBall& ball, QEvent::Type type, const QPointF& global, Qt::MouseButton button, Qt::MouseButtons buttons) {
+        QMouseEvent event(type, ball.mapFromGlobal(global), global, button, buttons, Qt::NoModifier);
+        QCoreApplication::sendEvent(&ball, &event);
+    }
+
+    void rightClick(FloatingBall& ball, const QPointF& global) {
+        mouse(ball, QEvent::MouseButtonPress, global, Qt::RightButton, Qt::RightButton);
+        mouse(ball, QEvent::MouseButtonRelease, global, Qt::RightButton, Qt::NoButton);
+    }
+
+    QPointF ballCenter(const FloatingBall& ball) {
+        return QPointF(ball.mapToGlobal(ball.rect().center()));
+    }
+
+    DamageResult playInteraction(FloatingBall& ball, bool damageTracking) {
+        FloatingBallProbe::reset(ball);
+        FloatingBallProbe::setDamageTracking(ball, damageTracking);
+        ball.update();
+        wait(300);   // 上一次运行的动画与重绘在计数开始前结束
+
+        FrameProfiler& profiler = ball.profiler();
+        profiler.setEnabled(true);
+        profiler.clear();
+        QElapsedTimer elapsed;
+        elapsed.start();
+
+        QPointF center = ballCenter(ball);
+        QEnterEvent enter(ball.mapFromGlobal(center), ball.mapFromGlobal(center), center);
+        QCoreApplication::sendEvent(&ball, &enter);
+        wait(700);
+
+        // 向上绕一圈后回到起点，远离屏幕边缘，不会触发停靠
+        mouse(ball, QEvent::MouseButtonPress, center, Qt::LeftButton, Qt::LeftButton);
+        for (int i = 1; i <= SweepSteps; ++i) {
+            const double a = 2.0 * std::numbers::pi * i / SweepSteps;
+            const QPointF p = center + QPointF(DragRadius * std::sin(a), DragRadius * (std::cos(a) - 1.0));
+            mouse(ball, QEvent::MouseMove, p, Qt::NoButton, Qt::LeftButton);
+            wait(InputIntervalMs);
+        }
+        mouse(ball, QEvent::MouseButtonRelease, center, Qt::LeftButton, Qt::NoButton);
+        wait(1000);
+
+        center = ballCenter(ball);
+        rightClick(ball, center);
+        wait(800);
+        const double radius = FloatingBallProbe::ringMidRadius(ball, 0);
+        for (int i = 0; i <= SweepSteps; ++i) {
+            const double a = 2.0 * std::numbers::pi * i / SweepSteps;
+            mouse(ball, QEvent::MouseMove, center + QPointF(radius * std::cos(a), -radius * std::sin(a)), Qt::NoButton, Qt::NoButton);
+            wait(InputIntervalMs);
+        }
+        rightClick(ball, center);
+        wait(800);
+
+        QEvent leave(QEvent::Leave);
+        QCoreApplication::sendEvent(&ball, &leave);
+        wait(700);
+
+        DamageResult result;
+        result.seconds = static_cast<double>(elapsed.nsecsElapsed()) / 1.0e9;
+        result.frames = profiler.frameCount();
+        result.pixels = profiler.totalPaintedPixels();
+        profiler.setEnabled(false);
+        return result;
+    }
+
+    void printDamage(const char* mode, const DamageResult& r) {
+        const double perFrame = r.frames == 0 ? 0.0 : static_cast<double>(r.pixels) / static_cast<double>(r.frames);
+        std::printf("%-10s %8.2f %8llu %14.0f %12.2f\n", mode, r.seconds, static_cast<unsigned long long>(r.frames),
+                    perFrame, static_cast<double>(r.pixels) / r.seconds / 1.0e6);
+    }
+
+    void writeJson(std::FILE* file, const std::vector<StateResult>& results) {
+        std::fprintf(file, "{\n  \"states\": [\n");
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            std::fprintf(file, "    {\"name\": \"%s\", \"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f",
+                         r.name.c_str(), r.p50Us, r.p90Us, r.p99Us, r.maxUs);
+            if (r.comparison.compared) {
+                std::fprintf(file, ", \"golden\": {\"missing\": %s, \"diff_pixels\": %lld, \"max_channel_diff\": %d}",
+                             r.comparison.missing ? "true" : "false", r.comparison.diffCount, r.comparison.maxDiff);
+            }
+            std::fprintf(file, "}%s\n", i + 1 == results.size() ? "" : ",");
+        }
+        std::fprintf(file, "  ]\n}\n");
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--golden" && i + 1 < argc) {
+            options.goldenDir = argv[++i];
+        } else if (arg == "--update") {
+            options.update = true;
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            options.tolerance = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--out" && i + 1 < argc) {
+            options.outDir = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--font" && i + 1 < argc) {
+            options.fontPath = argv[++i];
+        } else if (arg == "--damage") {
+            options.damage = true;
+        } else {
+            std::fprintf(stderr, "usage: %s [--frames <n>] [--golden <dir>] [--update] [--tolerance <n>] [--out <dir>] [--json <file|->] [--font <file>]\n"
+                                 "       %s --damage\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if (options.update && options.goldenDir.empty()) {
+        std::fprintf(stderr, "--update requires --golden <dir>\n");
+        return 2;
+    }
+    if (!options.outDir.empty()) QDir().mkpath(QString::fromStdString(options.outDir));
+
+    FloatingBall& ball = FloatingBallProbe::ball();
+
+    // 字体在创建 QApplication（ball()）之后才能注册；不使用 hinting，减少栅格化对 FreeType 配置的依赖
+    if (!options.fontPath.empty()) {
+        const int id = QFontDatabase::addApplicationFont(QString::fromStdString(options.fontPath));
+        const auto families = QFontDatabase::applicationFontFamilies(id);   // 加载失败时 id 为 -1，列表为空
+        if (families.isEmpty()) {
+            std::fprintf(stderr, "cannot load font %s\n", options.fontPath.c_str());
+            return 2;
+        }
+        QFont font(families.front(), 10);
+        font.setHintingPreference(QFont::PreferNoHinting);
+        FloatingBallProbe::setLabelFont(ball, font);
+    }
+
+    if (options.damage) {
+        ball.show();
+        const DamageResult tracked = playInteraction(ball, true);
+        const DamageResult full = playInteraction(ball, false);
+        std::printf("%-10s %8s %8s %14s %12s\n", "damage", "seconds", "frames", "px/frame", "Mpx/s");
+        printDamage("region", tracked);
+        printDamage("full", full);
+        if (full.pixels > 0) {
+            std::printf("region / full painted pixels: %.3f\n", static_cast<double>(tracked.pixels) / static_cast<double>(full.pixels));
+        }
+        return 0;
+    }
+
+    std::vector<StateResult> results;
+    for (const auto state : FloatingBallProbe::AllStates) {
+        results.push_back(run(ball, state, options));
+    }
+
+    bool failed = false;
+    const bool table = options.jsonPath != "-";
+    if (table) {
+        std::printf("label font: %s\n", QFontInfo(FloatingBallProbe::labelFont(ball)).family().toStdString().c_str());
+        std::printf("%-16s %10s %10s %10s %10s   %s\n", "state", "p50 us", "p90 us", "p99 us", "max us", "golden");
+    }
+    for (const auto& r : results) {
+        std::string golden = "-";
+        if (options.update) {
+            golden = "updated";
+        } else if (r.comparison.missing) {
+            golden = "missing";
+            failed = true;
+        } else if (r.comparison.compared) {
+            golden = r.comparison.diffCount == 0
+                ? "match (max diff " + std::to_string(r.comparison.maxDiff) + ")"
+                : "DIFF " + std::to_string(r.comparison.diffCount) + " px (max diff " + std::to_string(r.comparison.maxDiff) + ")";
+            failed |= r.comparison.diffCount > 0;
+        }
+        if (table) {
+            std::printf("%-16s %10.1f %10.1f %10.1f %10.1f   %s\n", r.name.c_str(), r.p50Us, r.p90Us, r.p99Us, r.maxUs, golden.c_str());
+        }
+    }
+
+    if (options.jsonPath == "-") {
+        writeJson(stdout, results);
+    } else if (!options.jsonPath.empty()) {
+        std::FILE* file = std::fopen(options.jsonPath.c_str(), "w");
+        if (!file) {
+            std::fprintf(stderr, "cannot open %s\n", options.jsonPath.c_str());
+            return 2;
+        }
+        writeJson(file, results);
+        std::fclose(file);
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,50 @@
+#include "Bench.h"
+
+#include <any>
+#include <string>
+#include <vector>
+
+#include "../Script/ClassRegistry.h"
+#include "../Script/ScriptObject.h"
+
+namespace {
+
+    // param 个方法的脚本对象，方法名形如 method0 ... methodN-1
+    class BenchObject : public ScriptObject {
+    public:
+        explicit BenchObject(std::size_t methodCount = 1) {
+            for (std::size_t i = 0; i < methodCount; ++i) {
+                registerMethod("method" + std::to_string(i), [](const std::vector<std::any>& args) -> std::any {
+                    return std::any_cast<int>(args[0]) + 1;
+                });
+            }
+        }
+    };
+
+}
+
+// 按名字调用最后注册的方法：一次哈希查找 + std::function 调用 + std::any 装箱
+KERUIS_BENCH("ScriptObject/call", {1, 16, 256}) {
+    BenchObject object(state.param());
+    const std::string name = "method" + std::to_string(state.param() - 1);
+    const std::vector<std::any> args{41};
+
+    while (state.keepRunning()) {
+        const std::any result = object.call(name, args);
+        Keruis::Bench::doNotOptimize(result.has_value());
+    }
+}
+
+// 注册表中有 param 个类时按名字创建对象：一次哈希查找 + make_shared
+KERUIS_BENCH("ClassRegistry/create", {1, 16, 256}) {
+    auto& registry = ClassRegistry::instance();
+    for (std::size_t i = 0; i < state.param(); ++i) {
+        registry.registerClass("BenchObject" + std::to_string(i), [] { return std::make_shared<BenchObject>(); });
+    }
+    const std::string name = "BenchObject" + std::to_string(state.param() - 1);
+
+    while (state.keepRunning()) {
+        auto object = registry.create(name);
+        Keruis::Bench::doNotOptimize(object.get());
+    }
+}
@@ -0,0 +1,187 @@
+#include "Bench.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include <QImage>
+#include <QPainter>
+#include <QPolygonF>
+
+#include "../src/core/draw/Trail/TrailPath.h"
+#include "../src/core/draw/Trail/TrailMesh.h"
+#include "../src/core/draw/Trail/TrailKernel.h"
+
+namespace {
+
+    constexpr int   FrameSize   = 760;
+    constexpr float TrailRadius = 40.0f;
+
+    // 在画布内生成一条螺旋形拖尾，节点数 = 容量
+    TrailPath makeTrail(std::size_t nodes, TrailPath::Storage storage = TrailPath::Storage::AoS) {
+        TrailPath trail(nodes, storage);
+        const QPointF center(FrameSize / 2.0, FrameSize / 2.0);
+        for (std::size_t i = 0; i < nodes; ++i) {
+            const double t = static_cast<double>(i) / static_cast<double>(nodes);
+            const double angle = t * 6.0 * M_PI;
+            const double radius = 40.0 + 300.0 * t;
+            trail.addPoint(center + QPointF(std::cos(angle) * radius, std::sin(angle) * radius), 1.0f);
+        }
+        return trail;
+    }
+
+    QImage makeFrame() {
+        QImage frame(FrameSize, FrameSize, QImage::Format_ARGB32_Premultiplied);
+        frame.fill(Qt::transparent);
+        return frame;
+    }
+
+}
+
+// 旧实现：每个四边形各自设置画刷并分配 QPolygonF
+KERUIS_BENCH("TrailFrame/perQuad", {100, 1000, 10000}) {
+    TrailPath trail = makeTrail(state.param());
+    QImage frame = makeFrame();
+
+    while (state.keepRunning()) {
+        QPainter painter(&frame);
+        painter.setRenderHint(QPainter::Antialiasing);
+
+        trail.each(TrailRadius, [&](int,
+                                    const QPointF& p1, const QPointF& p2,
+                                    const QPointF& p3, const QPointF& p4,
+                                    float progress1, float) {
+            const QColor color(141,196,233, static_cast<int>(255 * progress1));
+            painter.setBrush(color);
+            painter.setPen(Qt::NoPen);
+
+            QPolygonF quad({p1, p2, p3, p4});
+            painter.drawPolygon(quad);
+        });
+    }
+}
+
+KERUIS_BENCH("TrailFrame/mesh", {100, 1000, 10000}) {
+    TrailPath trail = makeTrail(state.param());
+    TrailMesh mesh;
+    QImage frame = makeFrame();
+
+    while (state.keepRunning()) {
+        QPainter painter(&frame);
+        painter.setRenderHint(QPainter::Antialiasing);
+
+        mesh.build(trail, TrailRadius);
+        mesh.paint(painter, QColor(141,196,233));
+    }
+}
+
+KERUIS_BENCH("TrailMesh/build", {100, 1000, 10000}) {
+    TrailPath trail = makeTrail(state.param());
+    TrailMesh mesh;
+
+    while (state.keepRunning()) {
+        mesh.build(trail, TrailRadius);
+        Keruis::Bench::doNotOptimize(mesh.quadCount());
+    }
+}
+
+KERUIS_BENCH("TrailMesh/buildSoA", {100, 1000, 10000}) {
+    TrailPath trail = makeTrail(state.param(), TrailPath::Storage::SoA);
+    TrailMesh mesh;
+
+    while (state.keepRunning()) {
+        mesh.build(trail, TrailRadius);
+        Keruis::Bench::doNotOptimize(mesh.quadCount());
+    }
+}
+
+// 满容量后的 addPoint：淘汰最旧节点 + 计算最新线段
+KERUIS_BENCH("TrailPath/addPoint", {100, 1000, 10000}) {
+    TrailPath trail = makeTrail(state.param(), TrailPath::Storage::SoA);
+
+    double t = 0.0;
+    while (state.keepRunning()) {
+        t += 0.01;
+        trail.addPoint(QPointF(FrameSize / 2.0 + std::cos(t) * 200.0, FrameSize / 2.0 + std::sin(t) * 200.0), 1.0f);
+    }
+    Keruis::Bench::doNotOptimize(trail.size());
+}
+
+KERUIS_BENCH("TrailPath/each", {100, 1000, 10000}) {
+    TrailPath trail = makeTrail(state.param(), TrailPath::Storage::SoA);
+
+    while (state.keepRunning()) {
+        double sum = 0.0;
+        trail.each(TrailRadius, [&](const QPointF& p1, const QPointF&, const QPointF&, const QPointF& p4) {
+            sum += p1.x() + p4.y();
+        });
+        Keruis::Bench::doNotOptimize(sum);
+    }
+}
+
+KERUIS_BENCH("TrailKernel/computeSegments", {100, 1000, 10000}) {
+    const std::size_t n = state.param();
+    std::vector<float> x(n), y(n), scale(n, 1.0f);
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = static_cast<float>(std::cos(i * 0.01) * 300.0);
+        y[i] = static_cast<float>(std::sin(i * 0.01) * 300.0);
+    }
+
+    std::vector<float> buffers[8];
+    for (auto& b : buffers) b.resize(n);
+    const Keruis::Trail::SegmentOutput out{
+        buffers[0].data(), buffers[1].data(), buffers[2].data(), buffers[3].data(),
+        buffers[4].data(), buffers[5].data(), buffers[6].data(), buffers[7].data()
+    };
+
+    while (state.keepRunning()) {
+        Keruis::Trail::computeSegments({x.data(), y.data(), scale.data(), n, TrailRadius, static_cast<float>(n - 1), 0.5f, 0.0f}, out);
+        Keruis::Bench::doNotOptimize(buffers[4][n / 2]);
+    }
+}
+
+// 稳态拖动：每帧加入一个节点再绘制。缓存生效时每帧只计算 1 个线段，其余全部复用
+KERUIS_BENCH("TrailPath/dragFrame", {100, 1000, 10000}) {
+    TrailPath trail = makeTrail(state.param(), TrailPath::Storage::SoA);
+    TrailMesh mesh;
+    trail.resetStats();
+
+    double t = 0.0;
+    while (state.keepRunning()) {
+        t += 0.01;
+        trail.addPoint(QPointF(FrameSize / 2.0 + std::cos(t) * 200.0, FrameSize / 2.0 + std::sin(t) * 200.0), 1.0f);
+        mesh.build(trail, TrailRadius);
+    }
+
+    const auto& stats = trail.stats();
+    const double frames = static_cast<double>(std::max<std::size_t>(stats.frames, 1));
+    state.counter("computedPerFrame", static_cast<double>(stats.computedSegments) / frames);
+    state.counter("reusedPerFrame", static_cast<double>(stats.reusedSegments) / frames);
+}
+
+// 模拟 8000 Hz 鼠标：param 为每个 125 Hz 帧内的输入事件数，每帧提交的节点数应与 param 无关
+KERUIS_BENCH("TrailPath/highRateInput", {1, 8, 64}) {
+    TrailPath trail(TrailPath::DefaultCapacity, TrailPath::Storage::SoA);
+    trail.setResampling({4.0f, std::chrono::milliseconds(800)});
+    TrailMesh mesh;
+
+    const auto events = static_cast<int>(state.param());
+    const auto step = std::chrono::microseconds(8000 / events);
+    auto time = TrailPath::Clock::time_point{};
+    double t = 0.0;
+    std::size_t frames = 0;
+    while (state.keepRunning()) {
+        for (int i = 0; i < events; ++i) {
+            t += 0.01 / events;
+            time += step;
+            trail.addPoint(QPointF(FrameSize / 2.0 + std::cos(t) * 200.0, FrameSize / 2.0 + std::sin(t) * 200.0), 1.0f, time);
+        }
+        trail.expire(time);
+        mesh.build(trail, TrailRadius);
+        ++frames;
+    }
+
+    const double n = static_cast<double>(std::max<std::size_t>(frames, 1));
+    state.counter("nodes", static_cast<double>(trail.size()));
+    state.counter("mergedPerFrame", static_cast<double>(trail.stats().mergedPoints) / n);
+}
@@ -0,0 +1,156 @@
+#include "Bench.h"
+
+#include <new>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+
+namespace {
+
+    std::atomic<std::size_t> g_allocations{0};
+
+}
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size != 0 ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)                 { return ::operator new(size); }
+void  operator delete(void* p) noexcept                { std::free(p); }
+void  operator delete[](void* p) noexcept              { std::free(p); }
+void  operator delete(void* p, std::size_t) noexcept   { std::free(p); }
+void  operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace Keruis::Bench {
+
+    std::size_t allocations() {
+        return g_allocations.load(std::memory_order_relaxed);
+    }
+
+    std::vector<Case>& registry() {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    Result run(const Case& benchCase, std::size_t param) {
+        using namespace std::chrono_literals;
+
+        // 先把迭代次数翻倍到单次至少 10ms，再重复测量取中位数
+        std::size_t iterations = 1;
+        for (;;) {
+            State state(param, iterations);
+            benchCase.body(state);
+            if (state.elapsedNs() >= 1e7 || iterations >= (std::size_t{1} << 30)) break;
+            iterations *= 2;
+        }
+
+        constexpr int repetitions = 5;
+        std::vector<double> samples;
+        samples.reserve(repetitions);
+        std::vector<std::pair<std::string, double>> counters;
+        for (int i = 0; i < repetitions; ++i) {
+            State state(param, iterations);
+            benchCase.body(state);
+            samples.push_back(state.elapsedNs() / static_cast<double>(iterations));
+            counters = state.counters();
+        }
+
+        std::ranges::sort(samples);
+        return Result{benchCase.name, param, iterations, samples[repetitions / 2], samples.front(), std::move(counters)};
+    }
+
+}
+
+namespace {
+
+    std::string jsonEscape(const std::string& text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (const char c : text) {
+            switch (c) {
+                case '"':  escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n";  break;
+                default:   escaped += c;      break;
+            }
+        }
+        return escaped;
+    }
+
+    // {"benchmarks": [{"name", "param", "iterations", "median_ns", "min_ns", "counters": {...}}, ...]}
+    void writeJson(std::FILE* file, const std::vector<Keruis::Bench::Result>& results) {
+        std::fprintf(file, "{\n  \"benchmarks\": [\n");
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto& result = results[i];
+            std::fprintf(file, "    {\"name\": \"%s\", \"param\": %zu, \"iterations\": %zu, \"median_ns\": %.3f, \"min_ns\": %.3f, \"counters\": {",
+                         jsonEscape(result.name).c_str(), result.param, result.iterations, result.medianNs, result.minNs);
+            for (std::size_t k = 0; k < result.counters.size(); ++k) {
+                std::fprintf(file, "%s\"%s\": %.17g", k == 0 ? "" : ", ",
+                             jsonEscape(result.counters[k].first).c_str(), result.counters[k].second);
+            }
+            std::fprintf(file, "}}%s\n", i + 1 == results.size() ? "" : ",");
+        }
+        std::fprintf(file, "  ]\n}\n");
+    }
+
+}
+
+// 用法：KeruisUtilsBench [--filter <子串>] [--json <文件>]
+//   --filter 只运行名字包含该子串的用例；--json 额外把结果写成 JSON（"-" 表示标准输出，此时不打印表格）
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string jsonPath;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--filter <substring>] [--json <file|->]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    const bool table = jsonPath != "-";
+    if (table) {
+        std::printf("%-40s %10s %12s %14s %14s\n", "benchmark", "param", "iterations", "median ns", "min ns");
+    }
+
+    std::vector<Keruis::Bench::Result> results;
+    for (const auto& benchCase : Keruis::Bench::registry()) {
+        if (!filter.empty() && benchCase.name.find(filter) == std::string::npos) continue;
+
+        for (const std::size_t param : benchCase.params) {
+            auto result = Keruis::Bench::run(benchCase, param);
+            if (table) {
+                std::printf("%-40s %10zu %12zu %14.1f %14.1f",
+                            result.name.c_str(), result.param, result.iterations, result.medianNs, result.minNs);
+                for (const auto& [name, value] : result.counters) {
+                    std::printf("  %s=%g", name.c_str(), value);
+                }
+                std::printf("\n");
+                std::fflush(stdout);
+            }
+            results.push_back(std::move(result));
+        }
+    }
+
+    if (jsonPath == "-") {
+        writeJson(stdout, results);
+    } else if (!jsonPath.empty()) {
+        std::FILE* file = std::fopen(jsonPath.c_str(), "w");
+        if (!file) {
+            std::fprintf(stderr, "cannot open %s\n", jsonPath.c_str());
+            return 1;
+        }
+        writeJson(file, results);
+        std::fclose(file);
+    }
+
+    return 0;
+}
@@ -1,70 +1,105 @@
 #include "FloatingBall.h"
 
+#include <chrono>
+#include <thread>
+#include <fstream>
+
+#include <QDir>
+#include <QDebug>
+#include <QFileInfo>
+#include <QScopeGuard>
+#include <QStandardPaths>
+
+#include "../core/render/RenderWorker.h"
+#include "../core/menu/MenuFile.h"
+
+struct FloatingBall::RenderThread {
+    FrameProfiler                       profiler = FloatingBallRenderer::makeProfiler();
+    FloatingBallRenderer                renderer{profiler};
+    RenderWorker<FloatingBallFrame>     worker;     // 最后构造、最先析构：线程退出后才销毁 renderer
+
+    explicit RenderThread(RenderWorker<FloatingBallFrame>::Ready ready)
+        : worker([this](QPainter& painter, const FloatingBallFrame& frame) {
+              FrameProfiler::Frame profile(profiler);
+              renderer.paint(painter, frame);
+          }, std::move(ready)) {}
+};
+
 // ======= 构造 & 初始化 =======
 
 FloatingBall::FloatingBall(QWidget* parent)
     : QWidget(parent),
-      m_hoverTimer(new QTimer(this)),
-      m_layerCount(4),
+      m_trailFadeTimer(new QTimer(this)),
+      m_usageSaveTimer(new QTimer(this)),
+      m_searchPollTimer(new QTimer(this)),
       m_expanded(false),
       m_selected(false),
       m_showSegments(false),
       m_innerRadius(40.0),
       m_hoveredIndex(-1),
       m_hoveredLayer(-1),
+      m_hoverTracking(false),
+      m_hoverStale(false),
+      m_wheelDelta(0),
+      m_menuDepth(0),
+      m_prefetchLayer(-1),
+      m_prefetchParent(MenuTree::Root),
       m_ballShrinkProgress(1.0),
       m_expandedLayerCount(0),
       m_eyeOpenProgress(1.0),
-      m_jellyRestoreAnimation(nullptr),
       m_isDragging(false),
-      m_dockDirection(DockDirection::None)
+      m_dockDirection(DockDirection::None),
+      m_trail(TrailPath::DefaultCapacity, TrailPath::Storage::SoA),
+      m_profiler(FloatingBallRenderer::makeProfiler()),
+      m_profilerOverlayVisible(false),
+      m_damageTracking(true),
+      m_renderer(m_profiler),
+      m_frameSequence(0),
+      m_frameScheduled(false),
+      m_droppedFrames(0),
+      m_windowExtent(MaxWindowExtent)
 {
     setupWindowFlags();
     setVisualStyle();
     centerToScreen();
     updateCenterPosition();
-    setupHoverTimer();
-
-    m_layerOpacities.resize(m_layerCount, 1.0);
+    setupTrail();
+    setupProfiler();
+    setupDamageTracking();
 
     m_currentLayer = 0;
 
-    m_layerSpacing.push_back(10.0);
-    m_layerSpacing.push_back(10.0);
-    m_layerSpacing.push_back(10.0);
-
-    m_layerRadii.push_back(100.0);
-    m_layerSegmentCounts.push_back(5);
-    m_gapAngle.push_back(5);
+    m_layout.addLayer(100.0, 10.0, 5, 5);
+    m_layout.addLayer(200.0, 10.0, 6, 5);
+    m_layout.addLayer(300.0, 10.0, 4, 5);
+    m_layout.addLayer(350.0, 10.0, 8, 5);
 
-    m_layerRadii.push_back(200.0);
-    m_layerSegmentCounts.push_back(6);
-    m_gapAngle.push_back(5);
+    setupAnimations();
 
-    m_layerRadii.push_back(300.0);
-    m_layerSegmentCounts.push_back(4);
-    m_gapAngle.push_back(5);
-
-    m_layerRadii.push_back(350.0);
-    m_layerSegmentCounts.push_back(8);
-    m_gapAngle.push_back(5);
+    setupUsage();
+    setupMenu();
+    updateWindowExtent();
+    setupRenderThread();
+}
 
-    m_currentLayerRadii = m_layerRadii;
+FloatingBall::~FloatingBall() {
+    m_renderThread.reset();
 
-    m_menuRootNodes = TESTgenerateMenu({5, 6, 4, 8}, 0,  "");
+    // 等待进行中的写入（失败时恢复 dirty），再同步写入尚未保存的记录
+    m_usageSaveTimer->stop();
+    if (m_usageWrite.valid() && !m_usageWrite.get()) m_usage.markDirty();
+    if (m_usage.dirty() && !m_usagePath.isEmpty()) UsageStore::write(m_usagePath, m_usage.serialize());
 
-    generateMenuLayers();
+    exportProfile();
 }
 
-FloatingBall::~FloatingBall() = default;
-
 void FloatingBall::setupWindowFlags() {
     setWindowFlags(Qt::FramelessWindowHint | Qt::Tool | Qt::WindowStaysOnTopHint);
     setAttribute(Qt::WA_TranslucentBackground);
 }
 
 void FloatingBall::setVisualStyle() {
-    setFixedSize(760, 760);
+    setFixedSize(MaxWindowExtent * 2, MaxWindowExtent * 2);
 }
 
 void FloatingBall::centerToScreen() {
@@ -76,362 +111,551 @@ void FloatingBall::updateCenterPosition() {
     m_centerGlobalPos = geometry().center();
 }
 
-void FloatingBall::setupHoverTimer() {
-    m_hoverTimer->setInterval(16);
-    connect(m_hoverTimer, &QTimer::timeout, this, &FloatingBall::updateHoveredByDirection);
-}
+// 窗口尺寸与输入区域跟随当前状态的内容：空闲时只有球体（及拖尾）大小，展开时为可见菜单层的外径，
+// 停靠时为胶囊大小。窗口以内容中心为基准缩放，中心的全局坐标保持不变
+void FloatingBall::updateWindowExtent() {
+    ContentShape shape = contentShape();
+
+    int extent = std::max(shape.ballExtent, shape.ringExtent);
+    if (shape.dock != DockDirection::None) extent = 32;
+    if (!shape.trail.isEmpty()) {
+        const QPoint center = rect().center();
+        extent = std::max({extent, center.x() - shape.trail.left(), shape.trail.right() - center.x(),
+                                   center.y() - shape.trail.top(),  shape.trail.bottom() - center.y()});
+    }
+    if (shape.overlay) extent = MaxWindowExtent;
 
-// ======= 绘制 =======
+    extent = (extent + WindowExtentStep - 1) / WindowExtentStep * WindowExtentStep;
+    if (setWindowExtent(std::clamp(extent, WindowExtentStep, MaxWindowExtent))) {
+        shape = contentShape();
+    }
 
-void FloatingBall::paintEvent(QPaintEvent*) {
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    if (shape == m_contentShape) return;
+    m_contentShape = shape;
 
-    switch (m_dockDirection) {
+    // 在支持的平台上 mask 同时裁剪绘制，所以需要覆盖所有可见内容（光晕、标签、拖尾、统计面板）
+    const QPoint center = rect().center();
+    const auto square = [&](int half) { return QRect(center.x() - half, center.y() - half, half * 2, half * 2); };
+
+    QRegion mask;
+    switch (shape.dock) {
         case DockDirection::Left:
         case DockDirection::Right:
-            drawDockedVerticalCapsule(painter);
-            return;
+            mask = QRect(center.x() - 12, center.y() - 32, 24, 64);
+            break;
         case DockDirection::Top:
         case DockDirection::Bottom:
-            drawDockedHorizontalCapsule(painter);
-            return;
+            mask = QRect(center.x() - 32, center.y() - 12, 64, 24);
+            break;
         case DockDirection::None:
             break;
     }
+    if (shape.ballExtent > 0) mask += QRegion(square(shape.ballExtent), QRegion::Ellipse);
+    if (shape.ringExtent > 0) mask += QRegion(square(shape.ringExtent), QRegion::Ellipse);
+    mask += shape.trail;
+    if (shape.overlay) mask += frameProfilerPanelRect(m_profiler, QPointF(8.0, 8.0)).toAlignedRect();
+
+    if (mask.isEmpty()) {
+        clearMask();
+    } else {
+        setMask(mask);
+    }
+}
+
+// 返回窗口尺寸是否发生了变化
+bool FloatingBall::setWindowExtent(int extent) {
+    if (extent == m_windowExtent) return false;
+
+    const QPoint center = pos() + rect().center();
+    m_windowExtent = extent;
+    setFixedSize(extent * 2, extent * 2);
+    move(center - rect().center());
+    updateCenterPosition();
+    return true;
+}
+
+FloatingBall::ContentShape FloatingBall::contentShape() const {
+    ContentShape shape;
+    shape.dock = m_dockDirection;
+    shape.overlay = m_profilerOverlayVisible;
+    if (m_dockDirection != DockDirection::None) return shape;
 
     if (m_ballShrinkProgress > 0.0) {
-        drawTrail(painter);
-        drawBall(painter);
+        shape.ballExtent = ballDamage().width() / 2;
+
+        if (const QRect trail = trailRect(); !trail.isEmpty()) {
+            const auto align = [](int v) {
+                return static_cast<int>(std::floor(static_cast<double>(v) / WindowExtentStep)) * WindowExtentStep;
+            };
+            shape.trail = QRect(QPoint(align(trail.left()), align(trail.top())),
+                                QPoint(align(trail.right()) + WindowExtentStep - 1, align(trail.bottom()) + WindowExtentStep - 1));
+        }
     }
 
-    if (m_showSegments && m_ballShrinkProgress <= 0.0) {
-        drawSegments(painter);
+    // 展开中的层按目标半径计算，避免展开动画逐帧改变窗口尺寸；收起中的层按当前半径计算
+    double ring = 0.0;
+    for (int layer = 0; layer < layerCount(); ++layer) {
+        const RadialLayout::Layer& spec = m_layout[layer];
+        if (layer < m_expandedLayerCount) ring = std::max(ring, spec.radius);
+        if (m_showSegments && spec.drawProgress > 0.0) ring = std::max(ring, spec.currentRadius);
     }
+    if (ring > 0.0) shape.ringExtent = static_cast<int>(std::ceil(ring)) + RingLayout::LabelExtent.width() + 2;
+
+    return shape;
 }
 
-void FloatingBall::drawBall(QPainter& painter) {
-    QPoint center = rect().center();
-    double r = m_innerRadius * m_ballShrinkProgress;
+void FloatingBall::setupTrail() {
+    // 节点沿拖动轨迹每 4 像素一个，与鼠标回报率无关：125 Hz 下以 500 像素/秒拖动时与逐个事件加入节点的间距相同，
+    // 容量对应的 400 像素也覆盖从窗口中心到边缘（MaxWindowExtent）的拖尾。
+    // 节点存活时间等于 125 Hz 下填满容量所需的时间，停下后拖尾逐渐缩短消失
+    m_trail.setResampling({
+        4.0f,
+        std::chrono::milliseconds(8 * TrailPath::DefaultCapacity)
+    });
 
-    double scaleX = 1.0 - m_jellyOffset.x() / (r * 2.0);
-    double scaleY = 1.0 - m_jellyOffset.y() / (r * 2.0);
-    scaleX = std::clamp(scaleX, 0.85, 1.15);
-    scaleY = std::clamp(scaleY, 0.85, 1.15);
+    m_trailFadeTimer->setInterval(16);
+    m_trailFadeTimer->setSingleShot(true);
+    // 节点只在这里过期，绘制时不修改拖尾，保证部分重绘时拖尾的其余部分仍与屏幕一致
+    connect(m_trailFadeTimer, &QTimer::timeout, this, [this]() {
+        if (m_trail.expire() > 0) requestUpdate(trailDamage());
+        if (!m_trail.empty()) m_trailFadeTimer->start();
+    });
+}
 
-    painter.save();
-    painter.translate(center);
-    painter.scale(scaleY, scaleX);
-    painter.translate(-center);
+// KERUIS_PROFILE=1 开启逐帧计时，=overlay 同时显示统计面板；
+// KERUIS_PROFILE_OUT=<文件> 在析构时导出最近的帧记录，.csv 为 CSV，其余为 Chrome trace JSON
+void FloatingBall::setupProfiler() {
+    const QString mode = qEnvironmentVariable("KERUIS_PROFILE");
+    if (mode.isEmpty() || mode == "0") return;
 
-    QRadialGradient gradient;
-    gradient.setCenter(center);
-    gradient.setFocalPoint(center.x() - r * 0.3, center.y() - r * 0.3);
-    gradient.setRadius(r);
+    m_profiler.setEnabled(true);
+    m_profilerOverlayVisible = (mode == "overlay");
+}
 
-    gradient.setColorAt(0.0, QColor(141,196,253, 200));
-    gradient.setColorAt(1.0, QColor(141,196,253, 140));
+// KERUIS_DAMAGE=0 关闭按区域重绘，每次都重绘整个窗口，用于与按区域重绘对比每秒重绘的像素数
+void FloatingBall::setupDamageTracking() {
+    m_damageTracking = qEnvironmentVariable("KERUIS_DAMAGE") != "0";
+}
 
-    QRectF ellipseRect(
-        center.x() - r,
-        center.y() - r,
-        r * 2,
-        r * 2
-    );
+// KERUIS_MENU=<文本菜单定义> 从文件加载菜单；未设置或加载失败时使用生成的测试菜单
+void FloatingBall::setupMenu() {
+    m_menuLevels.reserve(layerCount());
+    m_menuLevelKeys.reserve(layerCount());
+    m_menuOrders.reserve(layerCount());
 
-    double middleRadius = r * 0.5;
-    double middleInnerRadius = middleRadius * 0.7;
+    m_searchPollTimer->setInterval(SearchPollInterval);
+    connect(m_searchPollTimer, &QTimer::timeout, this, &FloatingBall::applySearchQuery);
 
-    QRectF middleRect(
-        center.x() - middleRadius,
-        center.y() - middleRadius,
-        middleRadius * 2,
-        middleRadius * 2
-    );
+    const QString source = qEnvironmentVariable("KERUIS_MENU");
+    if (!source.isEmpty()) {
+        QString error;
+        m_menu = MenuFile::load(source, MenuFile::compiledPath(source), &error);
+        if (!m_menu) qWarning().noquote() << "KERUIS_MENU:" << error;
+    }
+    if (!m_menu) m_menu = std::make_shared<const MenuTree>(TESTgenerateMenu({5, 6, 4, 8}));
 
-    QRectF middleInnerRect(
-        center.x() - middleInnerRadius,
-        center.y() - middleInnerRadius,
-        middleInnerRadius * 2,
-        middleInnerRadius * 2
-    );
+    resetItemOrders();
+    generateMenuLayers();
+}
 
-    QPainterPath middlePath, middleInnerPath;
-    middlePath.addEllipse(middleRect);
-    middleInnerPath.addEllipse(middleInnerRect);
-    middlePath = middlePath.subtracted(middleInnerPath);
+bool FloatingBall::loadMenu(const QString& sourcePath) {
+    QString error;
+    std::shared_ptr<const MenuTree> menu = MenuFile::load(sourcePath, MenuFile::compiledPath(sourcePath), &error);
+    if (!menu) {
+        qWarning().noquote() << "loadMenu:" << error;
+        return false;
+    }
 
-    QColor middleColor = QColor(178,219,251, 200);
+    setMenu(std::move(menu));
+    return true;
+}
 
-    double innerRadius = r * 0.3;
-    QRectF innerCircle(
-        center.x() - innerRadius,
-        center.y() - innerRadius,
-        innerRadius * 2,
-        innerRadius * 2
-    );
+// 更换菜单树：选中路径与各层的条目窗口回到开头，搜索索引在下次展开菜单时重建
+void FloatingBall::setMenu(std::shared_ptr<const MenuTree> menu) {
+    m_menu = std::move(menu);
+    m_searchBuild = {};
+    m_search.reset();
+    m_searchQuery.clear();
+    m_searchResults.reset();
+    m_searchPollTimer->stop();
+    resetItemOrders();
+    m_prefetchLayer = -1;
+    m_selectedSegments.clear();
+    m_menuDepth = 0;
+    for (int layer = 0; layer < layerCount(); ++layer) m_layout[layer].firstItem = 0;
 
-    QColor innerColor = QColor(124,164,223, 220);
+    generateMenuLayers();
+    requestUpdate();
+}
 
-    if (m_isDragging) {
-        painter.setBrush(QColor(0,0,0,255));
-        painter.drawEllipse(ellipseRect);
-    }
+// 使用频率保存在 <AppDataLocation>/usage.kusage；KERUIS_USAGE=<文件> 指定其他位置，=0 不读取也不记录。
+// 选中后不立即写入，UsageSaveDelay 内的多次选中合并为一次在后台线程的写入
+void FloatingBall::setupUsage() {
+    m_usageSaveTimer->setInterval(UsageSaveDelay);
+    m_usageSaveTimer->setSingleShot(true);
+    connect(m_usageSaveTimer, &QTimer::timeout, this, &FloatingBall::saveUsage);
 
-    painter.setBrush(gradient);
-    painter.setPen(Qt::NoPen);
-    painter.drawEllipse(ellipseRect);
-    painter.setBrush(middleColor);
-    painter.drawPath(middlePath);
-    painter.setBrush(innerColor);
-    painter.drawEllipse(innerCircle);
+    const QString path = qEnvironmentVariable("KERUIS_USAGE");
+    if (path == "0") return;
 
-    if (m_selected) {
-        QRadialGradient glowGradient;
-        glowGradient.setCenter(center);
-        glowGradient.setFocalPoint(center);
-        glowGradient.setRadius(r * 1.5);
+    m_usagePath = !path.isEmpty() ? path
+                : QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath(QStringLiteral("usage.kusage"));
+    m_usage.load(m_usagePath);
+}
 
-        glowGradient.setColorAt(0.0, QColor(209,248,255, 100));
-        glowGradient.setColorAt(0.7, QColor(209,248,255, 30));
-        glowGradient.setColorAt(1.0, QColor(209,248,255, 0));
+// 选中路径上的每一级都计数，上层菜单同样按使用频率排序，只重新计算路径上各级的顺序。
+// 已显示的各层不重新排序（条目不会在指针下移动），下次生成菜单层时才使用新的顺序
+void FloatingBall::recordUsage() {
+    if (m_usagePath.isEmpty()) return;
+
+    const std::int64_t now = QDateTime::currentSecsSinceEpoch();
+    MenuTree::Index node = MenuTree::Root;
+    UsageStore::Key key = UsageStore::RootKey;
+    for (const int item : m_selectedSegments) {
+        if (item < 0) break;
+        const MenuTree::Index parent = node;
+        const UsageStore::Key parentKey = key;
+        node = m_menu->child(parent, item);
+        if (node == MenuTree::Root) break;
+
+        key = UsageStore::childKey(parentKey, m_menu->label(node));
+        m_usage.record(key, now);
+        refreshItemOrder(parent, parentKey);
+        if ((*m_menu)[node].childCount == 0) break;
+    }
 
-        painter.setBrush(glowGradient);
-        painter.setPen(Qt::NoPen);
+    if (!m_usageSaveTimer->isActive()) m_usageSaveTimer->start();
+}
 
-        QRectF glowRect(
-            center.x() - r * 1.5,
-            center.y() - r * 1.5,
-            r * 3.0,
-            r * 3.0
-        );
+// 上一次写入尚未完成时推迟到下一轮。开始写入后再启动一次定时器收取结果：
+// 失败时恢复 dirty，不立即重试，下一次选中或退出时与新的记录一起写入
+void FloatingBall::saveUsage() {
+    if (m_usagePath.isEmpty()) return;
 
-        painter.drawEllipse(glowRect);
+    if (m_usageWrite.valid()) {
+        if (m_usageWrite.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            m_usageSaveTimer->start();
+            return;
+        }
+        if (!m_usageWrite.get()) {
+            qWarning().noquote() << "usage: cannot write" << m_usagePath;
+            m_usage.markDirty();
+            return;
+        }
     }
+    if (!m_usage.dirty()) return;
 
-    QPainterPath lowerMask, upperMask;
+    m_usageWrite = std::async(std::launch::async, [path = m_usagePath, data = m_usage.serialize()]() {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        return UsageStore::write(path, data);
+    });
+    m_usageSaveTimer->start();
+}
 
-    qreal offset = r * (1.0 - m_eyeOpenProgress);
+// KERUIS_RENDER_THREAD=1 在工作线程绘制
+void FloatingBall::setupRenderThread() {
+    if (qEnvironmentVariable("KERUIS_RENDER_THREAD") == "1") setRenderThreadEnabled(true);
+}
 
-    QRectF arcRect(center.x() - r, center.y() - r, r * 2, r * 2);
-    QPointF lowerEyeCenter(center.x(), center.y() + offset);
-    QPointF upperEyeCenter(center.x(), center.y() - offset);
+void FloatingBall::setRenderThreadEnabled(bool enabled) {
+    if (enabled == renderThreadEnabled()) return;
 
-    QPointF startLowerPoint(center.x() - r, center.y());
-    QPointF endLowerPoint(center.x() + r, center.y());
+    if (!enabled) {
+        m_renderThread.reset();
+        m_pendingDamage = QRegion();
+        requestUpdate();
+        return;
+    }
 
-    lowerMask.moveTo(startLowerPoint);
-    lowerMask.quadTo(lowerEyeCenter, endLowerPoint);
-    lowerMask.arcTo(arcRect, 0, -180);
+    // 完成的一帧在 GUI 线程请求重绘该帧的区域；窗口尺寸在快照之后变化时重绘整个窗口
+    m_renderThread = std::make_unique<RenderThread>([this](const FloatingBallFrame& frame) {
+        QMetaObject::invokeMethod(this, [this, size = frame.size, region = frame.region]() {
+            if (size != this->size()) {
+                update();
+            } else {
+                update(region);
+            }
+        }, Qt::QueuedConnection);
+    });
+    m_renderThread->profiler.setEnabled(m_profiler.enabled());
+    m_droppedFrames = 0;
+    requestUpdate();
+}
 
-    if (m_selected) {
-        gradient.setColorAt(0.0, QColor(220, 220, 220, 255));
-        gradient.setColorAt(1.0, QColor(180, 180, 180, 255));
+void FloatingBall::exportProfile() const {
+    const QString path = qEnvironmentVariable("KERUIS_PROFILE_OUT");
+    if (path.isEmpty() || m_profiler.frameCount() == 0) return;
+
+    std::ofstream out(path.toStdString());
+    if (path.endsWith(".csv", Qt::CaseInsensitive)) {
+        m_profiler.writeCsv(out);
     } else {
-        gradient.setColorAt(0.0, QColor(150, 150, 150, 255));
-        gradient.setColorAt(1.0, QColor(100, 100, 100, 255));
+        m_profiler.writeChromeTrace(out);
     }
+}
 
-    painter.setBrush(gradient);
-    painter.setPen(Qt::NoPen);
-    painter.drawPath(lowerMask);
+void FloatingBall::setProfilerOverlayVisible(bool visible) {
+    m_profilerOverlayVisible = visible;
+    if (visible) m_profiler.setEnabled(true);
+    requestUpdate();
+}
 
-    upperMask.moveTo(startLowerPoint);
-    upperMask.arcTo(arcRect, 180, -180);
-    upperMask.quadTo(upperEyeCenter, startLowerPoint);
-    painter.drawPath(upperMask);
-    painter.restore();
+void FloatingBall::requestUpdate() {
+    updateWindowExtent();
+    m_profiler.countUpdateRequest();
+    if (m_renderThread) {
+        scheduleFrame(rect());
+    } else {
+        update();
+    }
 }
 
-void FloatingBall::drawSegments(QPainter& painter) {
-    QPoint center = rect().center();
+void FloatingBall::requestUpdate(const QRegion& damage) {
+    if (!m_damageTracking) {
+        requestUpdate();
+        return;
+    }
 
-    QRectF innerRect(
-        center.x() - m_innerRadius,
-        center.y() - m_innerRadius,
-        m_innerRadius * 2,
-        m_innerRadius * 2
-    );
+    updateWindowExtent();
+    if (damage.isEmpty()) return;
 
-    for (int layer = 0; layer <= m_layerCount - 1; ++layer) {
-        const int segmentCount = m_layerSegmentCounts[layer];
-        const double radius = m_currentLayerRadii[layer];
-        const int gapAngle = m_gapAngle[layer];
-        const int spanAngle = (360 / segmentCount) - gapAngle;
+    m_profiler.countUpdateRequest();
 
-        QRectF outerRect(
-            center.x() - radius,
-            center.y() - radius,
-            radius * 2,
-            radius * 2
-        );
+    // 后台绘制时统计面板仍在 GUI 线程绘制，直接请求重绘
+    const QRect panel = m_profilerOverlayVisible ? frameProfilerPanelRect(m_profiler, QPointF(8.0, 8.0)).toAlignedRect() : QRect();
+    if (m_renderThread) {
+        scheduleFrame(damage);
+        if (!panel.isEmpty()) update(panel);
+    } else {
+        update(damage.united(panel));
+    }
+}
 
-        int angle = 0;
-        m_drawProgress.push_back(0.0);
+// 同一轮事件循环内的重绘请求合并为一个快照，在事件循环空闲时提交
+void FloatingBall::scheduleFrame(const QRegion& damage) {
+    m_pendingDamage += damage;
+    if (m_frameScheduled) return;
 
-        for (int i = 0; i < segmentCount; ++i) {
-            int visibleSpan = static_cast<int>(spanAngle * m_drawProgress[layer]);
-            if (visibleSpan <= 0) continue;
+    m_frameScheduled = true;
+    QMetaObject::invokeMethod(this, [this]() { submitFrame(); }, Qt::QueuedConnection);
+}
 
-            QColor color;
+void FloatingBall::submitFrame() {
+    m_frameScheduled = false;
+    if (!m_renderThread) return;
 
-            if (layer == m_hoveredLayer && i == m_hoveredIndex) {
-                color = QColor(255, 0, 0, 180);
-            } else if (m_selectedSegments.size() > layer && m_selectedSegments[layer] == i) {
-                color = QColor(180, 180, 180, 140);
-            } else {
-                color = QColor(100, 100, 100, 140);
-            }
+    captureFrame(m_frame, m_pendingDamage);
+    m_pendingDamage = QRegion();
 
-            int baseAlpha = color.alpha();
-            double layerOpacity = (m_layerOpacities.size() > layer) ? m_layerOpacities[layer] : 1.0;
-            color.setAlphaF((baseAlpha / 255.0) * layerOpacity);
-
-            QPainterPath path;
-            path.moveTo(center);
-            path.arcMoveTo(outerRect, angle);
-            path.arcTo(outerRect, angle, visibleSpan);
-            path.arcTo(innerRect, angle + visibleSpan, -visibleSpan);
-            path.closeSubpath();
-
-            painter.setBrush(color);
-            painter.setPen(Qt::NoPen);
-            painter.drawPath(path);
-
-            double midAngle = angle + visibleSpan / 2.0;
-            double textRadius = (radius + innerRect.width() / 2.0) / 2.0;
-            double rad = midAngle * M_PI / 180.0;
-            QPointF textPos(
-                center.x() + textRadius * std::cos(rad),
-                center.y() - textRadius * std::sin(rad)
-            );
-
-            QColor textColor = Qt::white;
-            textColor.setAlphaF(layerOpacity);
-            painter.setPen(textColor);
-            painter.setFont(QFont("Arial", 10));
-            QString text;
-            if (layer < m_menuLayers.size() && i < m_menuLayers[layer].size()) {
-                text = QString::fromStdString(m_menuLayers[layer][i]);
-            } else {
-                text = "?";
-            }
-            QRectF textRect(textPos.x() - 20, textPos.y() - 10, 40, 20);
-            painter.drawText(textRect, Qt::AlignCenter, text);
+    // ringDamage / segmentDamage 使用 GUI 线程这份扇区几何，工作线程的几何不能在这里读取
+    if (m_frame.showSegments && m_frame.ballShrinkProgress <= 0.0) m_renderer.layoutRings(m_frame);
 
-            angle += spanAngle + gapAngle;
-        }
+    m_renderThread->worker.submit(m_frame);
+}
 
-        innerRect = outerRect;
-        const int spacing = m_layerSpacing[layer];
-        innerRect.adjust(-spacing, -spacing, spacing, spacing);
-    }
+// 记录尚未绘制的最早一次输入，用于统计输入到绘制的延迟
+void FloatingBall::markInput() {
+    if (m_inputTime == FloatingBallFrame::Clock::time_point{}) m_inputTime = FloatingBallFrame::Clock::now();
 }
 
+QRect FloatingBall::ballDamage() const {
+    return FloatingBallRenderer::ballBounds(rect().center(), m_innerRadius);
+}
 
-void FloatingBall::drawDockedVerticalCapsule(QPainter &painter) {
-    QPoint center = rect().center();
+// 拖尾节点以全局坐标保存，换算到窗口坐标后按线段半宽扩展
+QRect FloatingBall::trailRect() const {
+    if (m_trail.empty()) return {};
+    const int margin = static_cast<int>(std::ceil(m_innerRadius)) + 2;
+    return m_trail.bounds().translated(-QPointF(pos())).toAlignedRect().adjusted(-margin, -margin, margin, margin);
+}
 
-    constexpr int capsuleWidth = 20;
-    constexpr int capsuleHeight = 60;
-    constexpr int radius = capsuleWidth / 2;
+// 上一次绘制的拖尾 + 当前拖尾
+QRect FloatingBall::trailDamage() const {
+    return m_paintedTrailRect.united(trailRect());
+}
 
-    QRectF topArcRect(
-        center.x() - radius,
-        center.y() - capsuleHeight / 2,
-        capsuleWidth,
-        capsuleWidth
-    );
+// 某层可能覆盖的环形区域：外径取完全展开的半径（收起动画中需要擦除更大的旧扇区），两侧留出标签的余量
+QRegion FloatingBall::ringDamage(int layer) const {
+    if (layer < 0 || layer >= layerCount()) return {};
 
-    QRectF bottomArcRect(
-        center.x() - radius,
-        center.y() + capsuleHeight / 2 - capsuleWidth,
-        capsuleWidth,
-        capsuleWidth
-    );
+    const QPoint center = rect().center();
+    const double margin = RingLayout::LabelExtent.width() + 2;
+    const double inner = m_layout.innerRadius(layer, m_innerRadius) - margin;
+    const double outer = std::max(m_layout[layer].radius, m_layout[layer].currentRadius) + margin;
 
-    QPainterPath path;
+    const auto disc = [&](double radius) {
+        const int r = static_cast<int>(std::ceil(std::max(radius, 0.0)));
+        return QRegion(center.x() - r, center.y() - r, r * 2, r * 2, QRegion::Ellipse);
+    };
 
-    path.moveTo(bottomArcRect.left(), bottomArcRect.center().y());
+    QRegion ring = disc(outer);
+    if (inner > 0.0) ring -= disc(std::floor(inner));
+
+    // 已构建的扇区（包括超出环形余量的标签）一并计入
+    if (const RingLayout::Layer* geometry = m_renderer.ringLayout().find(layer)) ring += geometry->bounds;
+    return ring;
+}
 
-    path.arcTo(bottomArcRect, 180, 180);
+QRect FloatingBall::segmentDamage(int layer, int index) const {
+    if (layer < 0 || index < 0) return {};
 
-    path.lineTo(topArcRect.right(), topArcRect.center().y());
+    const RingLayout::Layer* geometry = m_renderer.ringLayout().find(layer);
+    if (!geometry || index >= static_cast<int>(geometry->segments.size())) return {};
+    return geometry->segments[index].bounds;
+}
 
-    path.arcTo(topArcRect, 0, 180);
+// 补间只修改状态并累积重绘区域，每帧推进完所有补间后统一请求一次重绘
+void FloatingBall::setupAnimations() {
+    m_ballTween  = m_frameClock.add();
+    m_eyeTween   = m_frameClock.add();
+    m_jellyTween = m_frameClock.add();
+    m_dockTween  = m_frameClock.add();
 
-    path.lineTo(bottomArcRect.left(), bottomArcRect.center().y());
+    for (int layer = 0; layer < layerCount(); ++layer) {
+        m_radiusTweens.push_back(m_frameClock.add());
+        m_fadeTweens.push_back(m_frameClock.add());
+    }
 
-    path.closeSubpath();
+    m_frameClock.setOnFrame([this]() {
+        if (m_hoverStale) {
+            m_hoverStale = false;
+            updateHovered();
+        }
 
-    painter.setRenderHint(QPainter::Antialiasing);
-    painter.setBrush(QColor(220, 220, 220, 200));
-    painter.setPen(Qt::NoPen);
-    painter.drawPath(path);
+        if (m_frameDamage.isEmpty()) return;
+        requestUpdate(m_frameDamage);
+        m_frameDamage = QRegion();
+    });
 }
 
+void FloatingBall::damage(const QRegion& region) {
+    m_frameDamage += region;
+}
 
-void FloatingBall::drawDockedHorizontalCapsule(QPainter &painter) {
-    QPoint center = rect().center();
+void FloatingBall::setLayerRadius(int layer, double radius, double progress) {
+    m_layout.setCurrentRadius(layer, radius);
+    m_layout[layer].drawProgress = std::clamp(progress, 0.0, 1.0);
+    m_hoverStale = m_hoverTracking;
+    damage(ringDamage(layer));
+}
 
-    constexpr int capsuleWidth = 60;
-    constexpr int capsuleHeight = 20;
-    constexpr int radius = capsuleHeight / 2;
+// ======= 绘制 =======
 
-    QRectF leftArcRect(
-        center.x() - capsuleWidth / 2,
-        center.y() - radius,
-        capsuleHeight,
-        capsuleHeight
-    );
+// 绘制到窗口的 QPainter 已经被 Qt 裁剪到 event->region()；渲染器再跳过与该区域不相交的部分。
+// 后台绘制时这里只贴上工作线程最近完成的一帧
+void FloatingBall::paintEvent(QPaintEvent* event) {
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
 
-    QRectF rightArcRect(
-        center.x() + capsuleWidth / 2 - capsuleHeight,
-        center.y() - radius,
-        capsuleHeight,
-        capsuleHeight
-    );
+    {
+        FrameProfiler::Frame frame(m_profiler);
+        if (m_profiler.enabled()) {
+            m_profiler.setAnimationsAlive(m_frameClock.activeCount());
 
-    QPainterPath path;
+            std::uint64_t pixels = 0;
+            for (const QRect& r : event->region()) pixels += static_cast<std::uint64_t>(r.width()) * static_cast<std::uint64_t>(r.height());
+            m_profiler.setPaintedPixels(pixels);
+        }
 
-    path.moveTo(leftArcRect.center());
+        if (m_renderThread) {
+            presentFrame(painter);
+        } else {
+            drawFrame(painter, event->region());
+        }
+    }
 
-    path.arcTo(leftArcRect, 90, 180);
+    if (m_profilerOverlayVisible) {
+        paintFrameProfiler(painter, m_profiler, QPointF(8.0, 8.0));
+    }
+}
 
-    path.lineTo(rightArcRect.left(), rightArcRect.bottom());
+// 生成绘制快照。拖尾顶点在这里生成（TrailPath 只在 GUI 线程访问）；同步绘制时拖尾不与 region 相交则不生成，
+// 后台绘制时工作线程会扩大重绘区域（见 RenderWorker），总是生成
+void FloatingBall::captureFrame(FloatingBallFrame& frame, const QRegion& region) {
+    frame.size   = size();
+    frame.dpr    = devicePixelRatioF();
+    frame.region = region;
 
-    path.arcTo(rightArcRect, 270, 180);
+    switch (m_dockDirection) {
+        case DockDirection::Left:
+        case DockDirection::Right:
+            frame.dock = FloatingBallFrame::Dock::Vertical;
+            break;
+        case DockDirection::Top:
+        case DockDirection::Bottom:
+            frame.dock = FloatingBallFrame::Dock::Horizontal;
+            break;
+        case DockDirection::None:
+            frame.dock = FloatingBallFrame::Dock::None;
+            break;
+    }
 
-    path.lineTo(leftArcRect.right() - radius, leftArcRect.top());
+    frame.innerRadius        = m_innerRadius;
+    frame.ballShrinkProgress = m_ballShrinkProgress;
+    frame.jellyOffset        = m_jellyOffset;
+    frame.eyeOpenProgress    = m_eyeOpenProgress;
+    frame.selected           = m_selected;
+    frame.dragging           = m_isDragging;
+
+    frame.showSegments       = m_showSegments;
+    frame.layout             = m_layout;
+    frame.selectedSegments.assign(layerCount(), -1);
+    for (int layer = searching() ? 1 : 0; layer < layerCount(); ++layer) frame.selectedSegments[layer] = menuPosition(layer, selectedItem(layer));
+    frame.hoveredLayer       = m_hoveredLayer;
+    frame.hoveredIndex       = m_hoveredIndex;
+
+    frame.menu               = m_menu;
+    frame.menuLevels         = m_menuLevels;
+    frame.menuOrders         = m_menuOrders;
+    frame.searchResults      = m_searchResults;
+    frame.searchQuery        = m_searchQuery;
+    frame.prefetchLayer      = m_prefetchLayer;
+    frame.prefetchParent     = m_prefetchParent;
+    frame.prefetchOrder      = m_prefetchOrder;
+
+    frame.trail.clear();
+    if (frame.dock == FloatingBallFrame::Dock::None && m_ballShrinkProgress > 0.0) {
+        if (!m_trail.empty() && !m_trailFadeTimer->isActive()) {
+            m_trailFadeTimer->start();
+        }
 
-    path.closeSubpath();
+        // 拖尾变化时请求的区域总是覆盖旧拖尾与新拖尾，所以任何一次绘制之后屏幕上的拖尾都在 trailRect() 内
+        m_paintedTrailRect = trailRect();
+        if (m_renderThread || region.intersects(m_paintedTrailRect)) {
+            m_trailMesh.build(m_trail, m_innerRadius, this->pos());
+            frame.trail.assign(m_trailMesh.vertices().begin(), m_trailMesh.vertices().end());
+        }
+    }
 
-    painter.setRenderHint(QPainter::Antialiasing);
-    painter.setBrush(QColor(220, 220, 220, 200));
-    painter.setPen(Qt::NoPen);
-    painter.drawPath(path);
+    frame.sequence  = ++m_frameSequence;
+    frame.inputTime = std::exchange(m_inputTime, FloatingBallFrame::Clock::time_point{});
 }
 
+void FloatingBall::drawFrame(QPainter& painter, const QRegion& region) {
+    captureFrame(m_frame, region);
+    m_renderer.paint(painter, m_frame);
 
-void FloatingBall::drawTrail(QPainter &painter) {
-    const QPointF offset = this->pos();
-
-    m_trail.each(m_innerRadius, [&](int index,
-                          const QPointF& p1, const QPointF& p2,
-                          const QPointF& p3, const QPointF& p4,
-                          float progress1, float progress2) {
-        const QPointF lp1 = p1 - offset;
-        const QPointF lp2 = p2 - offset;
-        const QPointF lp3 = p3 - offset;
-        const QPointF lp4 = p4 - offset;
+    if (m_frame.inputTime != FloatingBallFrame::Clock::time_point{}) {
+        m_profiler.setInputLatency(std::chrono::duration<double, std::micro>(FloatingBallFrame::Clock::now() - m_frame.inputTime).count());
+    }
+}
 
-        const QColor color(141,196,233, static_cast<int>(255 * progress1));
-        painter.setBrush(color);
-        painter.setPen(Qt::NoPen);
+// 快照之后窗口尺寸可能已经改变（窗口以中心缩放），按中心对齐贴图
+void FloatingBall::presentFrame(QPainter& painter) {
+    m_renderThread->worker.present([&](const QImage& image, const FloatingBallFrame& frame, bool fresh) {
+        painter.save();
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(rect().center() - frame.rect().center(), image);
+        painter.restore();
 
-        QPolygonF quad({lp1, lp2, lp3, lp4});
-        painter.drawPolygon(quad);
+        if (fresh && frame.inputTime != FloatingBallFrame::Clock::time_point{}) {
+            m_profiler.setInputLatency(std::chrono::duration<double, std::micro>(FloatingBallFrame::Clock::now() - frame.inputTime).count());
+        }
     });
+
+    const std::uint64_t dropped = m_renderThread->worker.stats().dropped();
+    m_profiler.setDroppedFrames(static_cast<std::uint32_t>(dropped - m_droppedFrames));
+    m_droppedFrames = dropped;
 }
 
 
@@ -442,62 +666,39 @@ void FloatingBall::transformLayerAnimated(int layer) {
         return;
     }
 
-    if (layer >= m_layerCount) {
+    if (layer >= layerCount()) {
         onAllAnimationsFinished();
         return;
     }
 
-    double startRadius = (layer == 0) ? m_innerRadius
-                                      : m_layerRadii[layer - 1] + m_layerSpacing[layer - 1];
-    double targetRadius = m_layerRadii[layer];
+    double startRadius = m_layout.restingInnerRadius(layer, m_innerRadius);
+    double targetRadius = m_layout[layer].radius;
 
-    QVariantAnimation* animation = new QVariantAnimation(this);
-    animation->setDuration(350);
-    animation->setStartValue(startRadius);
-    animation->setEndValue(targetRadius);
-    animation->setEasingCurve(QEasingCurve::OutCubic);
-
-    connect(animation, &QVariantAnimation::valueChanged, this, [=, this] (const QVariant& value) {
-        m_currentLayerRadii[layer] = value.toDouble();
-        m_drawProgress[layer] = std::clamp((m_currentLayerRadii[layer] - startRadius) / (targetRadius - startRadius), 0.0, 1.0);
-        update();
-    });
-
-    connect(animation, &QVariantAnimation::finished, this, [=, this]() {
+    m_frameClock.start(m_radiusTweens[layer], 350, QEasingCurve::OutCubic, [=, this](qreal t) {
+        setLayerRadius(layer, std::lerp(startRadius, targetRadius, t), t);
+    }, [=, this]() {
         transformLayerAnimated(layer + 1);
     });
-
-    animation->start(QAbstractAnimation::DeleteWhenStopped);
 }
 
 void FloatingBall::transformToRadialMenu() {
     m_ballShrinkProgress = 1.0;
 
-    QVariantAnimation* shrinkAnim = new QVariantAnimation(this);
-    shrinkAnim->setDuration(300);
-    shrinkAnim->setStartValue(1.0);
-    shrinkAnim->setEndValue(0.0);
-    shrinkAnim->setEasingCurve(QEasingCurve::InOutCubic);
-
-    connect(shrinkAnim, &QVariantAnimation::valueChanged, this, [this](const QVariant& value) {
-        m_ballShrinkProgress = value.toDouble();
-        update();
-    });
-
-    connect(shrinkAnim, &QVariantAnimation::finished, this, [this]() {
+    m_frameClock.start(m_ballTween, 300, QEasingCurve::InOutCubic, [this](qreal t) {
+        m_ballShrinkProgress = 1.0 - t;
+        damage(QRegion(ballDamage()).united(trailDamage()));
+    }, [this]() {
         m_showSegments = true;
         transformLayerAnimated(0);
     });
-
-    shrinkAnim->start(QAbstractAnimation::DeleteWhenStopped);
 }
 
 void FloatingBall::onAllAnimationsFinished() {
     if (m_expanded) {
         m_showSegments = false;
-        m_drawProgress.clear();
+        m_layout.clearProgress();
         m_ballShrinkProgress = 1.0;
-        update();
+        requestUpdate();
     }
 
     m_expanded = !m_expanded;
@@ -513,61 +714,27 @@ void FloatingBall::collapseLayerAnimated(int layer) {
         return;
     }
 
-    double endRadius;
-    if (layer == 0) {
-        endRadius = m_innerRadius;
-    } else {
-        endRadius = m_layerRadii[layer - 1] + m_layerSpacing[layer - 1];
-    }
-
-    double startRadius = m_layerRadii[layer];
-
-    QVariantAnimation* animation = new QVariantAnimation(this);
-    animation->setDuration(350);
-    animation->setStartValue(startRadius);
-    animation->setEndValue(endRadius);
-    animation->setEasingCurve(QEasingCurve::InCubic);
-
-    connect(animation, &QVariantAnimation::valueChanged, this, [=, this](const QVariant& value) {
-        m_currentLayerRadii[layer] = value.toDouble();
-
-        double totalDistance = startRadius - endRadius;
-        m_drawProgress[layer] = std::clamp(
-            (m_currentLayerRadii[layer] - endRadius) / totalDistance,
-            0.0, 1.0
-        );
-
-        update();
-    });
+    double endRadius = m_layout.restingInnerRadius(layer, m_innerRadius);
+    double startRadius = m_layout[layer].radius;
 
-    connect(animation, &QVariantAnimation::finished, this, [=, this]() {
+    m_frameClock.start(m_radiusTweens[layer], 350, QEasingCurve::InCubic, [=, this](qreal t) {
+        setLayerRadius(layer, std::lerp(startRadius, endRadius, t), 1.0 - t);
+    }, [=, this]() {
         collapseLayerAnimated(layer - 1);
     });
-
-    animation->start(QAbstractAnimation::DeleteWhenStopped);
 }
 
 void FloatingBall::onCollapseFinished() {
     m_showSegments = false;
-    m_drawProgress.clear();
-
-    QVariantAnimation* growAnim = new QVariantAnimation(this);
-    growAnim->setDuration(300);
-    growAnim->setStartValue(0.0);
-    growAnim->setEndValue(1.0);
-    growAnim->setEasingCurve(QEasingCurve::OutCubic);
-
-    connect(growAnim, &QVariantAnimation::valueChanged, this, [this](const QVariant& value) {
-        m_ballShrinkProgress = value.toDouble();
-        update();
-    });
+    m_layout.clearProgress();
 
-    connect(growAnim, &QVariantAnimation::finished, this, [this]() {
+    m_frameClock.start(m_ballTween, 300, QEasingCurve::OutCubic, [this](qreal t) {
+        m_ballShrinkProgress = t;
+        damage(QRegion(ballDamage()).united(trailDamage()));
+    }, [this]() {
         m_expanded = false;
         m_expandedLayerCount = 0;
     });
-
-    growAnim->start(QAbstractAnimation::DeleteWhenStopped);
 }
 
 void FloatingBall::collapseLayersInRange(int fromLayer, int toLayer) {
@@ -580,38 +747,17 @@ void FloatingBall::collapseLayerAnimatedInRange(int currentLayer, int stopAtLaye
         return;
     }
 
-    double endRadius = (currentLayer == 0)
-        ? m_innerRadius
-        : m_layerRadii[currentLayer - 1] + m_layerSpacing[currentLayer - 1];
-
-    double startRadius = m_layerRadii[currentLayer];
-
-    QVariantAnimation* animation = new QVariantAnimation(this);
-    animation->setDuration(250);
-    animation->setStartValue(startRadius);
-    animation->setEndValue(endRadius);
-    animation->setEasingCurve(QEasingCurve::InCubic);
+    double endRadius = m_layout.restingInnerRadius(currentLayer, m_innerRadius);
+    double startRadius = m_layout[currentLayer].radius;
 
-    connect(animation, &QVariantAnimation::valueChanged, this, [=, this](const QVariant& value) {
-        m_currentLayerRadii[currentLayer] = value.toDouble();
-
-        double totalDistance = startRadius - endRadius;
-        m_drawProgress[currentLayer] = std::clamp(
-            (m_currentLayerRadii[currentLayer] - endRadius) / totalDistance,
-            0.0, 1.0
-        );
-
-        update();
-    });
-
-    connect(animation, &QVariantAnimation::finished, this, [=, this]() {
-        if (m_selectedSegments.size() > currentLayer)
-            m_selectedSegments[currentLayer] = -1;
+    m_frameClock.start(m_radiusTweens[currentLayer], 250, QEasingCurve::InCubic, [=, this](qreal t) {
+        setLayerRadius(currentLayer, std::lerp(startRadius, endRadius, t), 1.0 - t);
+    }, [=, this]() {
+        if (m_selectedSegments.size() > m_menuDepth + currentLayer)
+            m_selectedSegments[m_menuDepth + currentLayer] = -1;
 
         collapseLayerAnimatedInRange(currentLayer - 1, stopAtLayer);
     });
-
-    animation->start(QAbstractAnimation::DeleteWhenStopped);
 }
 
 void FloatingBall::fadeLayersInRange(int fromLayer, int toLayer) {
@@ -620,45 +766,23 @@ void FloatingBall::fadeLayersInRange(int fromLayer, int toLayer) {
 }
 
 void FloatingBall::fadeOutLayerInRange(int currentLayer, int toLayer) {
-    if (currentLayer > toLayer || currentLayer >= m_layerCount) return;
-
-    QVariantAnimation* fadeOut = new QVariantAnimation(this);
-    fadeOut->setDuration(200);
-    fadeOut->setStartValue(1.0);
-    fadeOut->setEndValue(0.0);
-    fadeOut->setEasingCurve(QEasingCurve::OutQuad);
+    if (currentLayer > toLayer || currentLayer >= layerCount()) return;
 
-    connect(fadeOut, &QVariantAnimation::valueChanged, this, [=, this](const QVariant& value) {
-        if (m_layerOpacities.size() > currentLayer)
-            m_layerOpacities[currentLayer] = value.toDouble();
-        update();
-    });
-
-    connect(fadeOut, &QVariantAnimation::finished, this, [=, this]() {
+    m_frameClock.start(m_fadeTweens[currentLayer], 200, QEasingCurve::OutQuad, [=, this](qreal t) {
+        m_layout[currentLayer].opacity = 1.0 - t;
+        damage(ringDamage(currentLayer));
+    }, [=, this]() {
         fadeInLayerInRange(currentLayer, toLayer);
     });
-
-    fadeOut->start(QAbstractAnimation::DeleteWhenStopped);
 }
 
 void FloatingBall::fadeInLayerInRange(int currentLayer, int toLayer) {
-    QVariantAnimation* fadeIn = new QVariantAnimation(this);
-    fadeIn->setDuration(200);
-    fadeIn->setStartValue(0.0);
-    fadeIn->setEndValue(1.0);
-    fadeIn->setEasingCurve(QEasingCurve::InQuad);
-
-    connect(fadeIn, &QVariantAnimation::valueChanged, this, [=, this](const QVariant& value) {
-        if (m_layerOpacities.size() > currentLayer)
-            m_layerOpacities[currentLayer] = value.toDouble();
-        update();
-    });
-
-    connect(fadeIn, &QVariantAnimation::finished, this, [=, this]() {
+    m_frameClock.start(m_fadeTweens[currentLayer], 200, QEasingCurve::InQuad, [=, this](qreal t) {
+        m_layout[currentLayer].opacity = t;
+        damage(ringDamage(currentLayer));
+    }, [=, this]() {
         fadeOutLayerInRange(currentLayer + 1, toLayer);
     });
-
-    fadeIn->start(QAbstractAnimation::DeleteWhenStopped);
 }
 
 
@@ -666,6 +790,8 @@ void FloatingBall::fadeInLayerInRange(int currentLayer, int toLayer) {
 
 
 void FloatingBall::mousePressEvent(QMouseEvent * event) {
+    markInput();
+
     if (event->button() == Qt::LeftButton) {
         startJellyRestoreElastic();
         stickToNearestEdge(true);
@@ -674,8 +800,32 @@ void FloatingBall::mousePressEvent(QMouseEvent * event) {
             return;
         }
 
-        if (m_expandedLayerCount >= m_layerCount) {
-            if ((m_hoveredLayer + 1) == m_layerCount) {
+        if (searching() && m_hoveredLayer == 0) {
+            if (m_hoveredIndex >= 0) activateSearchResult(m_layout.itemAt(0, m_hoveredIndex));
+            return;
+        }
+
+        // 点击球体回到上一级菜单
+        if (m_hoveredLayer < 0 && m_menuDepth > 0) {
+            const QPointF delta = event->globalPosition() - QPointF(mapToGlobal(rect().center()));
+            if (Keruis::Math::fast_hypot<Keruis::Math::Precision::Medium>(delta.x(), delta.y()) <= m_innerRadius) {
+                ascendMenu();
+                return;
+            }
+        }
+
+        if (m_expandedLayerCount >= layerCount()) {
+            if ((m_hoveredLayer + 1) == layerCount()) {
+                const int item = menuItem(m_hoveredLayer, m_layout.itemAt(m_hoveredLayer, m_hoveredIndex));
+                if (descendMenu(m_hoveredLayer, item)) return;
+
+                if (item >= 0) {
+                    if (m_selectedSegments.size() < m_menuDepth + layerCount())
+                        m_selectedSegments.resize(m_menuDepth + layerCount(), -1);
+                    m_selectedSegments[m_menuDepth + m_hoveredLayer] = item;
+                }
+                recordUsage();
+
                 for (int i = 0; i < m_selectedSegments.size(); ++i) {
                     int index = m_selectedSegments[i];
                     if (index != -1) {
@@ -690,14 +840,18 @@ void FloatingBall::mousePressEvent(QMouseEvent * event) {
         }
 
         if (m_hoveredLayer >= 0 && m_hoveredIndex >= 0) {
-            if (m_selectedSegments.size() < m_layerCount)
-                m_selectedSegments.resize(m_layerCount, -1);
-            m_selectedSegments[m_hoveredLayer] = m_hoveredIndex;
+            if (m_selectedSegments.size() < m_menuDepth + layerCount())
+                m_selectedSegments.resize(m_menuDepth + layerCount(), -1);
+            m_selectedSegments[m_menuDepth + m_hoveredLayer] = menuItem(m_hoveredLayer, m_layout.itemAt(m_hoveredLayer, m_hoveredIndex));
 
-            generateMenuLayers();
+            // 外层换成了新的子菜单，窗口回到开头
+            for (int layer = m_hoveredLayer + 1; layer < layerCount(); ++layer) m_layout[layer].firstItem = 0;
+
+            updateMenuLayers(m_hoveredLayer);
+            requestUpdate();
         }
 
-        if (m_hoveredLayer + 1 < m_layerCount) {
+        if (m_hoveredLayer + 1 < layerCount()) {
             if ((m_hoveredLayer + 1) == m_expandedLayerCount) {
                 m_expandedLayerCount++;
                 transformLayerAnimated(m_hoveredLayer + 1);
@@ -715,23 +869,68 @@ void FloatingBall::mousePressEvent(QMouseEvent * event) {
         if (m_dockDirection == DockDirection::None) {
             if (!m_expanded && (m_expandedLayerCount == 0)) {
                 m_expandedLayerCount = 1;
-                m_hoverTimer->start();
+                startHoverTracking(event->globalPosition().toPoint());
                 transformToRadialMenu();
+
+                // 展开期间接收键盘输入用于搜索
+                activateWindow();
+                setFocus(Qt::PopupFocusReason);
+                prepareSearch();
+                updatePrefetch();
             } else {
-                m_hoverTimer->stop();
-                transformToCollapsedState();
-                m_expandedLayerCount = 0;
-                std::ranges::fill(m_selectedSegments, -1);
+                collapseMenu();
             }
         }
     }
 }
 
 
+// 菜单展开时输入文字搜索整棵菜单树：Backspace 删除一个字符，Esc 退出搜索，Enter 选中排名第一的结果
+void FloatingBall::keyPressEvent(QKeyEvent* event) {
+    if (m_expandedLayerCount == 0) {
+        QWidget::keyPressEvent(event);
+        return;
+    }
+
+    markInput();
+    switch (event->key()) {
+        case Qt::Key_Escape:
+            setSearchQuery({});
+            return;
+        case Qt::Key_Backspace:
+            setSearchQuery(m_searchQuery.chopped(std::min<qsizetype>(m_searchQuery.size(), 1)));
+            return;
+        case Qt::Key_Return:
+        case Qt::Key_Enter:
+            if (searching()) activateSearchResult(0);
+            return;
+        default:
+            break;
+    }
+
+    const QString text = event->text();
+    if (!text.isEmpty() && text.at(0).isPrint()) {
+        setSearchQuery(m_searchQuery + text);
+        return;
+    }
+    QWidget::keyPressEvent(event);
+}
+
+// 菜单展开时开启了 mouse tracking，没有按键的移动只用于悬停判定
 void FloatingBall::mouseMoveEvent(QMouseEvent *event) {
+    markInput();
+    if (m_hoverTracking) {
+        m_hoverPos = event->globalPosition().toPoint();
+        updateHovered();
+    }
+    if (event->buttons() == Qt::NoButton) return;
+
     stickToNearestEdge(false);
 
-    m_isDragging = false;
+    if (m_isDragging) {
+        m_isDragging = false;
+        requestUpdate(ballDamage());
+    }
 
     if (event->buttons() & Qt::LeftButton) {
         if (m_expandedLayerCount == 0) {
@@ -740,24 +939,43 @@ void FloatingBall::mouseMoveEvent(QMouseEvent *event) {
     }
 }
 
+// 滚轮在悬停的层内移动条目窗口，每 120（一格）移动一个条目
+void FloatingBall::wheelEvent(QWheelEvent* event) {
+    if (!m_hoverTracking || m_hoveredLayer < 0 || !m_layout[m_hoveredLayer].paged()) {
+        m_wheelDelta = 0;
+        event->ignore();
+        return;
+    }
+
+    markInput();
+    m_wheelDelta += event->angleDelta().y();
+    const int steps = m_wheelDelta / 120;
+    m_wheelDelta -= steps * 120;
+
+    if (steps != 0 && m_layout.scroll(m_hoveredLayer, -steps)) {
+        requestUpdate(ringDamage(m_hoveredLayer));
+    }
+    event->accept();
+}
+
 void FloatingBall::closeEvent(QCloseEvent *event) {
     QWidget::closeEvent(event);
 }
 
 void FloatingBall::enterEvent(QEnterEvent* event) {
     m_selected = true;
-    QPropertyAnimation* anim = new QPropertyAnimation(this, "eyeOpenProgress");
-    anim->setStartValue(m_eyeOpenProgress);
-    anim->setEndValue(-0.8);
-    anim->setDuration(500);
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
+    animateEyeOpenProgress(-0.8f);
 }
 
 void FloatingBall::leaveEvent(QEvent* event) {
     m_selected = false;
     m_isDragging = false;
 
+    // 指针离开输入区域（mask）时已不在任何扇区上
+    if (m_hoverTracking) setHovered(-1, -1);
+
     m_trail.clear();
+    requestUpdate(trailDamage());
 
     if (m_dockDirection != DockDirection::None) {
         stickToNearestEdge(true);
@@ -767,15 +985,20 @@ void FloatingBall::leaveEvent(QEvent* event) {
         startJellyRestoreElastic();
     }
 
-    QPropertyAnimation* anim = new QPropertyAnimation(this, "eyeOpenProgress");
-    anim->setStartValue(m_eyeOpenProgress);
-    anim->setEndValue(1.8);
-    anim->setDuration(500);
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
+    animateEyeOpenProgress(1.8f);
+}
+
+void FloatingBall::animateEyeOpenProgress(float target) {
+    const float start = m_eyeOpenProgress;
+    m_frameClock.start(m_eyeTween, 500, QEasingCurve::Linear, [=, this](qreal t) {
+        m_eyeOpenProgress = std::lerp(start, target, static_cast<float>(t));
+        damage(ballDamage());
+    });
 }
 
+// 拖动偏移相对窗口中心保存，拖动过程中窗口随拖尾改变尺寸时不会跳动
 void FloatingBall::storeDragOffset(const QPoint& globalPos) {
-    m_dragOffset = globalPos - frameGeometry().topLeft();
+    m_dragOffset = globalPos - (pos() + rect().center());
     m_lastDragPos = globalPos;
 }
 
@@ -793,47 +1016,36 @@ void FloatingBall::performDrag(const QPoint& globalPos) {
 
     m_lastDragPos = globalPos;
 
-    move(globalPos - m_dragOffset);
+    move(globalPos - m_dragOffset - rect().center());
     updateCenterPosition();
-    update();
+    requestUpdate(QRegion(ballDamage()).united(trailDamage()));
 }
 
-void FloatingBall::startHoverTimer() {
-    if (!m_hoverTimer->isActive()) {
-        m_hoverTimer->start();
-    }
+// 悬停由鼠标移动事件驱动，指针静止时不做任何工作；菜单层半径变化时在下一帧按最后的指针位置重新判定
+void FloatingBall::startHoverTracking(const QPoint& globalPos) {
+    m_hoverTracking = true;
+    m_hoverPos = globalPos;
+    setMouseTracking(true);
+    updateHovered();
 }
 
-void FloatingBall::stopHoverTimer() {
-    if (m_hoverTimer->isActive()) {
-        m_hoverTimer->stop();
-    }
+void FloatingBall::stopHoverTracking() {
+    m_hoverTracking = false;
+    m_hoverStale = false;
+    setMouseTracking(false);
+    setHovered(-1, -1);
 }
 
 void FloatingBall::startJellyRestoreElastic() {
-    if (m_jellyRestoreAnimation) {
-        m_jellyRestoreAnimation->stop();
-        m_jellyRestoreAnimation->deleteLater();
-    }
-
-    m_jellyRestoreAnimation = new QVariantAnimation(this);
-    m_jellyRestoreAnimation->setDuration(600);
-    m_jellyRestoreAnimation->setStartValue(m_jellyOffset);
-    m_jellyRestoreAnimation->setEndValue(QPointF(0, 0));
+    const QPointF start = m_jellyOffset;
 
-    m_jellyRestoreAnimation->setEasingCurve(QEasingCurve::OutElastic);
-
-    connect(m_jellyRestoreAnimation, &QVariantAnimation::valueChanged, this, [=](const QVariant &value) {
-        m_jellyOffset = value.toPointF();
-        update();
-    });
-
-    connect(m_jellyRestoreAnimation, &QVariantAnimation::finished, this, [=]() {
+    m_frameClock.start(m_jellyTween, 600, QEasingCurve::OutElastic, [=, this](qreal t) {
+        m_jellyOffset = start * (1.0 - t);
+        damage(ballDamage());
+    }, [this]() {
         m_jellyOffset = QPointF(0, 0);
-        update();
+        damage(ballDamage());
     });
-
-    m_jellyRestoreAnimation->start();
 }
 
 void FloatingBall::stickToNearestEdge(bool isDocked) {
@@ -851,6 +1063,12 @@ void FloatingBall::stickToNearestEdge(bool isDocked) {
     int minDist = std::min({leftDist, rightDist, topDist, bottomDist});
     QPoint targetCenter = center;
 
+    // 停靠状态切换时球体 / 胶囊 / 拖尾整体变化，重绘整个窗口
+    const DockDirection previousDirection = m_dockDirection;
+    const auto repaintOnChange = qScopeGuard([&]() {
+        if (m_dockDirection != previousDirection) requestUpdate();
+    });
+
     if (minDist > snapThreshold) {
         m_dockDirection = DockDirection::None;
         return;
@@ -870,132 +1088,401 @@ void FloatingBall::stickToNearestEdge(bool isDocked) {
         m_dockDirection = DockDirection::Bottom;
     }
 
+    // 先切换到停靠状态的窗口尺寸，再按新尺寸计算动画终点
+    updateWindowExtent();
+
     if (isDocked) {
         QPoint offset = rect().center();
         QPoint targetTopLeft = targetCenter - offset;
 
-        QPropertyAnimation* anim = new QPropertyAnimation(this, "pos");
-        anim->setDuration(200);
-        anim->setStartValue(this->pos());
-        anim->setEndValue(targetTopLeft);
-        anim->setEasingCurve(QEasingCurve::OutQuad);
-        anim->start(QAbstractAnimation::DeleteWhenStopped);
+        const QPointF startTopLeft = this->pos();
+
+        m_frameClock.start(m_dockTween, 200, QEasingCurve::OutQuad, [=, this](qreal t) {
+            move((startTopLeft + (QPointF(targetTopLeft) - startTopLeft) * t).toPoint());
+        });
     }
 }
 
 
-void FloatingBall::updateHoveredByDirection() {
-    QPoint globalMousePos = QCursor::pos();
+void FloatingBall::updateHovered() {
     QPoint globalCenter = mapToGlobal(rect().center());
-    QPointF delta = globalMousePos - globalCenter;
-    double distance = std::hypot(delta.x(), delta.y());
+    QPointF delta = m_hoverPos - globalCenter;
+    double distance = Keruis::Math::fast_hypot<Keruis::Math::Precision::Medium>(delta.x(), delta.y());
 
     if (distance < 5) {
-        m_hoveredLayer = -1;
-        m_hoveredIndex = -1;
-        update();
+        setHovered(-1, -1);
         return;
     }
 
-    double angle = std::atan2(-delta.y(), delta.x()) * 180 / M_PI;
+    double angle = Keruis::Math::fast_atan2<Keruis::Math::Precision::Medium>(-delta.y(), delta.x()) * 180 / M_PI;
     if (angle < 0) angle += 360;
 
-    int layer = -1;
-    for (int i = 0; i < m_layerCount; ++i) {
-        double innerRadius = (i == 0) ? m_innerRadius : m_currentLayerRadii[i - 1] + m_layerSpacing[i - 1];
-        double outerRadius = m_currentLayerRadii[i];
-        if (distance >= innerRadius && distance <= outerRadius) {
-            layer = i;
-            break;
+    const RadialLayout::Hit hit = m_layout.hitTest(distance, angle, m_innerRadius);
+    setHovered(hit.layer, hit.index);
+}
+
+// 只重绘悬停状态变化的两个扇区，悬停不变时不请求重绘
+void FloatingBall::setHovered(int layer, int index) {
+    if (layer == m_hoveredLayer && index == m_hoveredIndex) return;
+
+    const QRect previous = segmentDamage(m_hoveredLayer, m_hoveredIndex);
+    m_hoveredLayer = layer;
+    m_hoveredIndex = index;
+    updatePrefetch();
+    requestUpdate(QRegion(previous).united(segmentDamage(m_hoveredLayer, m_hoveredIndex)));
+}
+
+
+int FloatingBall::getHoveredSegmentFromAngle(int layer, double angle) const {
+    return m_layout.segmentAt(layer, angle);
+}
+
+// ======= Menu =======
+
+// 从根沿选中路径走到第 m_menuDepth 级，之后每一级对应一层；菜单深度不受层数限制。
+// 各层只记录父节点，条目是菜单树中的连续子节点区间（menuLayer），不复制标签
+void FloatingBall::generateMenuLayers() {
+    m_menuLevels.clear();
+    m_menuLevelKeys.clear();
+    m_menuOrders.clear();
+
+    MenuTree::Index parent = MenuTree::Root;
+    UsageStore::Key key = UsageStore::RootKey;
+    for (int depth = 0; depth < m_menuDepth; ++depth) {
+        parent = selectedChild(parent, depth);
+        if (parent == MenuTree::Root) {
+            updateItemCounts();
+            return;
         }
+        key = UsageStore::childKey(key, m_menu->label(parent));
     }
 
-    if (layer == -1) {
-        m_hoveredLayer = -1;
-        m_hoveredIndex = -1;
-    } else {
-        m_hoveredLayer = layer;
-        m_hoveredIndex = getHoveredSegmentFromAngle(layer, angle);
+    pushMenuLevel(parent, key);
+    extendMenuLayers();
+}
+
+// 第 layer 层的选中项变化：只重新确定更外面的各层
+void FloatingBall::updateMenuLayers(int layer) {
+    if (layer >= m_menuLevels.size()) return;
+
+    m_menuLevels.resize(layer + 1);
+    m_menuLevelKeys.resize(layer + 1);
+    m_menuOrders.resize(layer + 1);
+    extendMenuLayers();
+}
+
+// 从已有的最外层沿选中路径向外补齐；m_menuLevels 的容量在构造时预留为层数，这里不分配内存
+void FloatingBall::extendMenuLayers() {
+    while (!m_menuLevels.empty() && m_menuLevels.size() < layerCount()) {
+        const int depth = m_menuDepth + static_cast<int>(m_menuLevels.size()) - 1;
+        const MenuTree::Index child = selectedChild(m_menuLevels.back(), depth);
+        if (child == MenuTree::Root) break;
+
+        pushMenuLevel(child, UsageStore::childKey(m_menuLevelKeys.back(), m_menu->label(child)));
     }
 
-    update();
+    updateItemCounts();
 }
 
+void FloatingBall::pushMenuLevel(MenuTree::Index parent, UsageStore::Key key) {
+    m_menuLevels.push_back(parent);
+    m_menuLevelKeys.push_back(key);
+    m_menuOrders.push_back(itemOrder(parent, key));
+}
 
-int FloatingBall::getHoveredSegmentFromAngle(int layer, double angle) const {
-    const int segmentCount = m_layerSegmentCounts[layer];
-    const int gapAngle = m_gapAngle[layer];
-    const int spanAngle = (360 / segmentCount) - gapAngle;
-    const int fullSpan = spanAngle + gapAngle;
+// 按父节点缓存，同一个子菜单再次显示时不重新排序；命中时只复制 shared_ptr，不分配内存
+std::shared_ptr<const UsageStore::Order> FloatingBall::itemOrder(MenuTree::Index parent, UsageStore::Key key) {
+    std::uint32_t& slot = m_itemOrderSlots[parent];
+    if (slot == 0) {
+        std::shared_ptr<const UsageStore::Order> order = m_usage.order(*m_menu, parent, key);
+        if (!order) {
+            slot = 1;
+        } else {
+            slot = static_cast<std::uint32_t>(m_itemOrders.size()) + 2;
+            m_itemOrders.push_back(std::move(order));
+        }
+    }
+    return slot == 1 ? nullptr : m_itemOrders[slot - 2];
+}
+
+// 记录使用后重新计算 parent 的顺序；尚未计算过的留到显示时。已显示的层与绘制线程持有的仍是旧的顺序
+void FloatingBall::refreshItemOrder(MenuTree::Index parent, UsageStore::Key key) {
+    std::uint32_t& slot = m_itemOrderSlots[parent];
+    if (slot == 0) return;
+    if (slot == 1) {
+        slot = static_cast<std::uint32_t>(m_itemOrders.size()) + 2;
+        m_itemOrders.emplace_back();
+    }
+    m_itemOrders[slot - 2] = m_usage.order(*m_menu, parent, key);
+}
+
+// 槽位数组按节点数一次分配，之后显示子菜单不再分配
+void FloatingBall::resetItemOrders() {
+    m_itemOrderSlots.assign(m_menu->nodes().size(), 0);
+    m_itemOrders.clear();
+}
+
+// 第 layer 层第 position 个位置显示的条目（子项下标）；搜索时第 0 层的位置就是结果的下标
+int FloatingBall::menuItem(int layer, int position) const {
+    if (position < 0 || layer < 0 || layer >= m_menuOrders.size() || (searching() && layer == 0)) return position;
+    const UsageStore::Order* order = m_menuOrders[layer].get();
+    return (order && position < order->items.size()) ? static_cast<int>(order->items[position]) : position;
+}
 
-    for (int i = 0; i < segmentCount; ++i) {
-        int startAngle = i * fullSpan;
-        int endAngle = startAngle + spanAngle;
+int FloatingBall::menuPosition(int layer, int item) const {
+    if (item < 0 || layer < 0 || layer >= m_menuOrders.size() || (searching() && layer == 0)) return item;
+    const UsageStore::Order* order = m_menuOrders[layer].get();
+    return (order && item < order->positions.size()) ? static_cast<int>(order->positions[item]) : item;
+}
 
-        if (startAngle <= angle && angle < endAngle)
-            return i;
-        if (endAngle > 360 && angle < (endAngle - 360))
-            return i;
+// 下一步最可能展开的子菜单，由绘制时预先排版标签并构建几何：悬停条目的子菜单；
+// 没有悬停时为第 0 层排在最前（最常用）的条目的子菜单
+void FloatingBall::updatePrefetch() {
+    int layer = m_hoveredLayer;
+    int item = layer >= 0 ? menuItem(layer, m_layout.itemAt(layer, m_hoveredIndex)) : -1;
+    if (layer < 0 && m_expandedLayerCount == 1 && !searching()) {
+        layer = 0;
+        item = menuItem(0, 0);
     }
 
-    return -1;
+    m_prefetchLayer = -1;
+    m_prefetchOrder.reset();
+    if (layer < 0 || layer + 1 >= layerCount() || layer >= m_menuLevels.size() || item < 0 || (searching() && layer == 0)) return;
+
+    const MenuTree::Index parent = m_menu->child(m_menuLevels[layer], item);
+    if (parent == MenuTree::Root || (*m_menu)[parent].childCount == 0) return;
+
+    m_prefetchLayer = layer + 1;
+    m_prefetchParent = parent;
+    m_prefetchOrder = itemOrder(parent, UsageStore::childKey(m_menuLevelKeys[layer], m_menu->label(parent)));
 }
 
-// ======= Menu =======
+// parent 在第 depth 级选中的、还有子菜单的子节点，没有时返回 Root
+MenuTree::Index FloatingBall::selectedChild(MenuTree::Index parent, int depth) const {
+    if (depth >= m_selectedSegments.size() || m_selectedSegments[depth] < 0) return MenuTree::Root;
 
-void FloatingBall::generateMenuLayers() {
-    m_menuLayers.clear();
+    const MenuTree::Index child = m_menu->child(parent, m_selectedSegments[depth]);
+    if (child == MenuTree::Root || (*m_menu)[child].childCount == 0) return MenuTree::Root;
+    return child;
+}
 
-    const std::vector<MenuNode>* currentLevel = &m_menuRootNodes;
+void FloatingBall::updateItemCounts() {
+    for (int layer = 0; layer < layerCount(); ++layer) {
+        m_layout.setItemCount(layer, static_cast<int>(menuLayer(layer).size()));
+    }
+    if (searching()) m_layout.setItemCount(0, static_cast<int>(m_searchResults->size()));
+}
 
-    for (int depth = 0; ; ++depth) {
-        std::vector<std::string> layerLabels;
+std::span<const MenuTree::Node> FloatingBall::menuLayer(int layer) const {
+    if (layer < 0 || layer >= m_menuLevels.size()) return {};
+    return m_menu->children(m_menuLevels[layer]);
+}
 
-        for (const auto& node : *currentLevel) {
-            layerLabels.push_back(node.label);
-        }
-        m_menuLayers.push_back(layerLabels);
+int FloatingBall::selectedItem(int layer) const {
+    const std::size_t level = static_cast<std::size_t>(m_menuDepth + layer);
+    return level < m_selectedSegments.size() ? m_selectedSegments[level] : -1;
+}
 
-        if (depth  >= m_selectedSegments.size()) break;
+const MenuTree::Node* FloatingBall::menuNode(int layer, int item) const {
+    const std::span<const MenuTree::Node> level = menuLayer(layer);
+    if (item < 0 || item >= level.size()) return nullptr;
+    return &level[item];
+}
 
-        int selected = m_selectedSegments[depth];
-        if (selected < 0 || selected >= currentLevel->size())
-            break;
+// 最外层的条目还有子菜单时，各层向内移动一级，最外层显示它的子菜单
+bool FloatingBall::descendMenu(int layer, int item) {
+    const MenuTree::Node* node = menuNode(layer, item);
+    if (!node || node->childCount == 0) return false;
 
-        currentLevel = &(*currentLevel)[selected].children;
-        if (currentLevel->empty())
-            break;
+    if (m_selectedSegments.size() < m_menuDepth + layerCount())
+        m_selectedSegments.resize(m_menuDepth + layerCount(), -1);
+    m_selectedSegments[m_menuDepth + layer] = item;
+
+    ++m_menuDepth;
+    for (int i = 0; i + 1 < layerCount(); ++i) m_layout[i].firstItem = m_layout[i + 1].firstItem;
+    m_layout[layerCount() - 1].firstItem = 0;
+
+    generateMenuLayers();
+    requestUpdate();
+    return true;
+}
+
+// 各层向外移动一级；第 0 层重新显示上一级，窗口移到其选中的条目处
+bool FloatingBall::ascendMenu() {
+    if (m_menuDepth == 0) return false;
+
+    --m_menuDepth;
+    for (int i = layerCount() - 1; i > 0; --i) m_layout[i].firstItem = m_layout[i - 1].firstItem;
+    m_layout[0].firstItem = 0;
+
+    generateMenuLayers();
+    m_layout.reveal(0, menuPosition(0, selectedItem(0)));
+    requestUpdate();
+    return true;
+}
+
+// ======= Search =======
+
+// 索引在分离的后台线程建立（菜单树构建后不再修改）。不使用 std::async：它返回的 future 析构时会等待建立完成，
+// setMenu 在建立期间丢弃 future 会阻塞 GUI 线程；packaged_task 的 future 析构不等待，过期的建立在后台完成后随线程释放
+void FloatingBall::prepareSearch() {
+    if (m_search || m_searchBuild.valid()) return;
+    std::packaged_task<std::unique_ptr<MenuSearch>()> build([menu = m_menu]() { return std::make_unique<MenuSearch>(menu); });
+    m_searchBuild = build.get_future();
+    std::thread(std::move(build)).detach();
+}
+
+// 尚未建立完成时返回 nullptr，不等待
+MenuSearch* FloatingBall::searchIndex() {
+    if (!m_search) {
+        prepareSearch();
+        if (m_searchBuild.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return nullptr;
+        m_search = m_searchBuild.get();
     }
+    return m_search.get();
 }
 
-std::vector<FloatingBall::MenuNode> FloatingBall::TESTgenerateMenu(
-    const std::vector<int>& branchingPerLevel,
-    int depth,
-    const std::string& prefix
-) {
-    std::vector<MenuNode> nodes;
+void FloatingBall::setSearchQuery(const QString& query) {
+    if (query == m_searchQuery) return;
 
-    if (depth >= branchingPerLevel.size())
-        return nodes;
+    m_searchQuery = query;
+    applySearchQuery();
+}
 
-    int branchingFactor = branchingPerLevel[depth];
+// 第 0 层临时显示按匹配程度排序的前 MaxSearchResults 个结果，开始搜索时收起外层。
+// 索引尚未建立完成时只显示输入的文字，m_searchPollTimer 每 SearchPollInterval 检查一次，完成后再应用当时的查询
+void FloatingBall::applySearchQuery() {
+    const bool wasSearching = searching();
+
+    if (m_searchQuery.isEmpty()) {
+        m_searchPollTimer->stop();
+        m_searchResults.reset();
+        if (m_search) m_search->search({}, 0);
+        m_layout[0].firstItem = 0;
+        updateItemCounts();
+        m_layout.reveal(0, menuPosition(0, selectedItem(0)));
+        requestUpdate();
+        return;
+    }
 
-    for (int i = 0; i < branchingFactor; ++i) {
-        std::string label;
+    MenuSearch* const search = searchIndex();
+    if (!search) {
+        if (!m_searchPollTimer->isActive()) m_searchPollTimer->start();
+        requestUpdate();
+        return;
+    }
+    m_searchPollTimer->stop();
+    m_layout[0].firstItem = 0;
 
-        if (prefix.empty()) {
-            label = std::string(1, 'A' + i);
-        } else if (depth + 1 == branchingPerLevel.size()) {
-            label = prefix + std::to_string(i + 1);
-        } else if (std::isdigit(prefix.back())) {
-            label = prefix + static_cast<char>('a' + i);
-        } else {
-            label = prefix + std::to_string(i + 1);
+    const QByteArray utf8 = m_searchQuery.toUtf8();
+    const std::span<const MenuTree::Index> results = search->search(std::string_view(utf8.constData(), utf8.size()), MaxSearchResults);
+    m_searchResults = std::make_shared<const std::vector<MenuTree::Index>>(results.begin(), results.end());
+
+    if (!wasSearching && m_expandedLayerCount > 1) {
+        collapseLayersInRange(1, m_expandedLayerCount - 1);
+        m_expandedLayerCount = 1;
+    }
+
+    updateItemCounts();
+    requestUpdate();
+}
+
+// 叶子节点：与点击最外层相同，依次发出路径上每一级的 segmentClicked 并收起菜单；
+// 其余节点：选中到该节点，各层移到能同时显示它与它的子菜单的位置并展开到子菜单所在的层
+void FloatingBall::activateSearchResult(int item) {
+    if (!m_searchResults || item < 0 || static_cast<std::size_t>(item) >= m_searchResults->size()) return;
+
+    const MenuTree::Index node = (*m_searchResults)[item];
+    const int level = m_search->depth(node);
+    m_search->path(node, m_selectedSegments);
+    m_searchQuery.clear();
+    m_searchResults.reset();
+    m_search->search({}, 0);
+
+    if ((*m_menu)[node].childCount == 0) {
+        recordUsage();
+        for (int i = 0; i < m_selectedSegments.size(); ++i) {
+            emit segmentClicked(i, m_selectedSegments[i]);
+        }
+        collapseMenu();
+        return;
+    }
+
+    m_menuDepth = std::max(0, level + 2 - layerCount());
+    generateMenuLayers();
+    for (int layer = 0; layer < layerCount(); ++layer) {
+        m_layout[layer].firstItem = 0;
+        m_layout.reveal(layer, menuPosition(layer, selectedItem(layer)));
+    }
+
+    const int expanded = std::min(level - m_menuDepth + 2, layerCount());
+    if (m_expandedLayerCount < expanded) {
+        const int from = m_expandedLayerCount;
+        m_expandedLayerCount = expanded;
+        transformLayerAnimated(from);
+    }
+    requestUpdate();
+}
+
+void FloatingBall::collapseMenu() {
+    stopHoverTracking();
+    transformToCollapsedState();
+    m_expandedLayerCount = 0;
+    std::ranges::fill(m_selectedSegments, -1);
+    m_menuDepth = 0;
+    m_searchQuery.clear();
+    m_searchResults.reset();
+    m_searchPollTimer->stop();
+    if (m_search) m_search->search({}, 0);
+    m_prefetchLayer = -1;
+    m_prefetchOrder.reset();
+    for (int layer = 0; layer < layerCount(); ++layer) m_layout[layer].firstItem = 0;
+    generateMenuLayers();
+}
+
+// 按层序一趟生成：第 depth 级的节点在数组中连续，依次为每个节点追加它的全部子节点
+MenuTree FloatingBall::TESTgenerateMenu(const std::vector<int>& branchingPerLevel) {
+    MenuTree tree;
+
+    std::size_t total = 0, levelSize = 1;
+    for (const int branching : branchingPerLevel) {
+        levelSize *= static_cast<std::size_t>(branching);
+        total += levelSize;
+    }
+    tree.reserve(total + 1);
+
+    MenuTree::Index levelBegin = MenuTree::Root, levelEnd = MenuTree::Root + 1;
+    std::string label;
+
+    for (std::size_t depth = 0; depth < branchingPerLevel.size(); ++depth) {
+        const int branchingFactor = branchingPerLevel[depth];
+        const bool last = depth + 1 == branchingPerLevel.size();
+        const MenuTree::Index nextBegin = levelEnd;
+
+        for (MenuTree::Index parent = levelBegin; parent < levelEnd; ++parent) {
+            const std::string_view prefix = tree.label(parent);
+            const MenuTree::Index first = tree.appendChildren(parent, branchingFactor);
+
+            for (int i = 0; i < branchingFactor; ++i) {
+                label.assign(prefix);
+
+                if (prefix.empty()) {
+                    label = std::string(1, 'A' + i);
+                } else if (last) {
+                    label += std::to_string(i + 1);
+                } else if (std::isdigit(prefix.back())) {
+                    label += static_cast<char>('a' + i);
+                } else {
+                    label += std::to_string(i + 1);
+                }
+
+                tree.setLabel(first + i, label);
+            }
         }
 
-        auto children = TESTgenerateMenu(branchingPerLevel, depth + 1, label);
-        nodes.emplace_back(label, children);
+        levelBegin = nextBegin;
+        levelEnd = static_cast<MenuTree::Index>(tree.size() + 1);
     }
 
-    return nodes;
+    return tree;
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <memory>
+#include <span>
 #include <vector>
 #include <deque>
+#include <future>
 #include <ranges>
 #include <algorithm>
 
@@ -10,27 +13,32 @@
 #include <QPainter>
 #include <QPainterPath>
 #include <QMouseEvent>
+#include <QWheelEvent>
+#include <QKeyEvent>
 #include <QApplication>
-#include <QPropertyAnimation>
 #include <QTimer>
 #include <QDateTime>
 #include <QGraphicsDropShadowEffect>
 #include <QElapsedTimer>
 
 #include "FloatingBall.h"
+#include "FloatingBallRenderer.h"
 #include "../core/draw/Trail/TrailPath.h"
+#include "../core/draw/Trail/TrailMesh.h"
+#include "../core/draw/Ring/RadialLayout.h"
+#include "../core/menu/MenuTree.h"
+#include "../core/menu/MenuSearch.h"
+#include "../core/menu/UsageStore.h"
+#include "../core/draw/Ring/RingLayout.h"
+#include "../core/anim/FrameClock.h"
+#include "../core/profile/FrameProfiler.h"
+#include "../core/profile/FrameProfilerOverlay.h"
 #include "../../Script/ClassRegistry.h"
-#include "../../Tool/window/WindowController.h"
 
 class FloatingBall : public QWidget {
     Q_OBJECT
 
-    struct MenuNode {
-        std::string label;
-        std::vector<MenuNode> children;
-
-        MenuNode(const std::string& label, const std::vector<MenuNode>& children) : label(label), children(children) {}
-    };
+    friend struct FloatingBallProbe;
 
     struct Ripple {
         float progress = 0.0f;
@@ -38,6 +46,9 @@ class FloatingBall : public QWidget {
         QPoint center;
     };
 
+    // 后台绘制线程：独立的 FloatingBallRenderer 与 FrameProfiler（均不是线程安全的）+ RenderWorker
+    struct RenderThread;
+
     enum class DockDirection {
         None,
         Left,
@@ -46,19 +57,49 @@ class FloatingBall : public QWidget {
         Bottom
     };
 
+    // 窗口半边长的上限为原固定窗口 760×760 的一半，拖尾超出的部分与之前一样被裁掉；
+    // 半边长按 WindowExtentStep 取整，内容的小幅变化不会引起窗口尺寸变化
+    static constexpr int MaxWindowExtent  = 380;
+    static constexpr int WindowExtentStep = 16;
+
+    // 当前状态下可见内容的形状（窗口坐标），决定窗口尺寸与输入区域
+    struct ContentShape {
+        DockDirection dock       = DockDirection::None;
+        int           ballExtent = 0;     // 0 表示不绘制球体
+        int           ringExtent = 0;     // 0 表示没有可见的菜单层
+        QRect         trail;              // 对齐到 WindowExtentStep
+        bool          overlay    = false;
+
+        bool operator==(const ContentShape&) const = default;
+    };
+
 public:
     explicit FloatingBall               (QWidget* parent = nullptr)                                     ;
     ~FloatingBall                       () override                                                     ;
 
-    void setSelected                    (bool selected)            { m_selected = selected; update(); } ;
+    void setSelected                    (bool selected)            { m_selected = selected; requestUpdate(ballDamage()); } ;
 
     [[nodiscard]] QPoint centerGlobalPos()                          const { return m_centerGlobalPos; } ;
     [[nodiscard]] bool   isSelected     ()                          const { return        m_selected; } ;
 
+    [[nodiscard]] FrameProfiler& profiler()                               { return m_profiler; }       ;
+    void setProfilerOverlayVisible      (bool visible)                                                  ;
+
+    [[nodiscard]] SpriteCache& spriteCache()                              { return m_renderer.spriteCache(); } ;
+
+    // 开启后在工作线程绘制，paintEvent 只贴上最近完成的一帧
+    void setRenderThreadEnabled         (bool enabled)                                                  ;
+    [[nodiscard]] bool renderThreadEnabled()                        const { return m_renderThread != nullptr; } ;
+
+    // 从文本菜单定义加载，编译结果缓存在 MenuFile::compiledPath；失败时保留当前菜单并返回 false
+    bool loadMenu                       (const QString& sourcePath)                                     ;
+
 protected:
     void paintEvent                     (QPaintEvent*)              override                            ;
     void mousePressEvent                (QMouseEvent*)              override                            ;
     void mouseMoveEvent                 (QMouseEvent*)              override                            ;
+    void wheelEvent                     (QWheelEvent*)              override                            ;
+    void keyPressEvent                  (QKeyEvent*)                override                            ;
     void closeEvent                     (QCloseEvent*)              override                            ;
     void enterEvent                     (QEnterEvent*)              override                            ;
     void leaveEvent                     (QEvent*)                   override                            ;
@@ -68,13 +109,45 @@ private:
     void setVisualStyle                 ()                                                              ;
     void centerToScreen                 ()                                                              ;
     void updateCenterPosition           ()                                                              ;
-    void setupHoverTimer                ()                                                              ;
-
-    void drawBall                       (QPainter& painter)                                             ;
-    void drawSegments                   (QPainter& painter)                                             ;
-    void drawDockedVerticalCapsule      (QPainter& painter)                                             ;
-    void drawDockedHorizontalCapsule    (QPainter& painter)                                             ;
-    void drawTrail                      (QPainter& painter)                                             ;
+    void updateWindowExtent             ()                                                              ;
+    bool setWindowExtent                (int extent)                                                    ;
+    [[nodiscard]] ContentShape contentShape()                         const                             ;
+    void setupTrail                     ()                                                              ;
+    void setupProfiler                  ()                                                              ;
+    void setupDamageTracking            ()                                                              ;
+    void setupRenderThread              ()                                                              ;
+    void setupMenu                      ()                                                              ;
+    void setMenu                        (std::shared_ptr<const MenuTree> menu)                          ;
+    void collapseMenu                   ()                                                              ;
+    void setupUsage                     ()                                                              ;
+    void recordUsage                    ()                                                              ;
+    void saveUsage                      ()                                                              ;
+
+    void prepareSearch                  ()                                                              ;
+    MenuSearch* searchIndex             ()                                                              ;
+    void setSearchQuery                 (const QString& query)                                          ;
+    void applySearchQuery               ()                                                              ;
+    void activateSearchResult           (int item)                                                      ;
+    bool searching                      ()                            const { return m_searchResults != nullptr; } ;
+    void exportProfile                  ()                            const                             ;
+    void requestUpdate                  ()                                                              ;
+    void requestUpdate                  (const QRegion& damage)                                         ;
+    [[nodiscard]] QRect   ballDamage    ()                            const                             ;
+    [[nodiscard]] QRect   trailRect     ()                            const                             ;
+    [[nodiscard]] QRect   trailDamage   ()                            const                             ;
+    [[nodiscard]] QRegion ringDamage    (int layer)                   const                             ;
+    [[nodiscard]] QRect   segmentDamage (int layer, int index)        const                             ;
+    void setupAnimations                ()                                                              ;
+    void damage                         (const QRegion& region)                                         ;
+    void setLayerRadius                 (int layer, double radius, double progress)                     ;
+    void animateEyeOpenProgress         (float target)                                                  ;
+
+    void captureFrame                   (FloatingBallFrame& frame, const QRegion& region)               ;
+    void drawFrame                      (QPainter& painter, const QRegion& region)                      ;
+    void presentFrame                   (QPainter& painter)                                             ;
+    void scheduleFrame                  (const QRegion& damage)                                         ;
+    void submitFrame                    ()                                                              ;
+    void markInput                      ()                                                              ;
     void storeDragOffset                (const QPoint& globalPos)                                       ;
     void performDrag                    (const QPoint& globalPos)                                       ;
 
@@ -90,36 +163,73 @@ private:
     void fadeOutLayerInRange            (int currentLayer, int toLayer)                                 ;
     void fadeInLayerInRange             (int currentLayer, int toLayer)                                 ;
 
-    void startHoverTimer                ()                                                              ;
-    void stopHoverTimer                 ()                                                              ;
+    void startHoverTracking             (const QPoint& globalPos)                                       ;
+    void stopHoverTracking              ()                                                              ;
 
     void startJellyRestoreElastic       ()                                                              ;
     void stickToNearestEdge             (bool isDocked)                                                 ;
 
-    void updateHoveredByDirection       ()                                                              ;
+    void updateHovered                  ()                                                              ;
+    void setHovered                     (int layer, int index)                                          ;
     int  getHoveredSegmentFromAngle     (int layer, double angle)     const                             ;
+    int  layerCount                     ()                            const { return static_cast<int>(m_layout.size()); } ;
 
     Q_PROPERTY  (float eyeOpenProgress READ eyeOpenProgress WRITE setEyeOpenProgress)
     float eyeOpenProgress               () const        { return m_eyeOpenProgress;                     }
-    void  setEyeOpenProgress            (float value)   {m_eyeOpenProgress = value;update();            }
+    void  setEyeOpenProgress            (float value)   {m_eyeOpenProgress = value;requestUpdate(ballDamage());}
 
     void generateMenuLayers             ()                                                              ;
-    std::vector<MenuNode> TESTgenerateMenu(
-        const std::vector<int>& branchingPerLevel,
-        int depth,
-        const std::string& prefix
-    );
+    void updateMenuLayers               (int layer)                                                     ;
+    void extendMenuLayers               ()                                                              ;
+    void updateItemCounts               ()                                                              ;
+    MenuTree::Index selectedChild       (MenuTree::Index parent, int depth) const                       ;
+    void pushMenuLevel                  (MenuTree::Index parent, UsageStore::Key key)                   ;
+    std::shared_ptr<const UsageStore::Order> itemOrder(MenuTree::Index parent, UsageStore::Key key)     ;
+    void refreshItemOrder               (MenuTree::Index parent, UsageStore::Key key)                   ;
+    void resetItemOrders                ()                                                              ;
+    int  menuItem                       (int layer, int position)     const                             ;
+    int  menuPosition                   (int layer, int item)         const                             ;
+    void updatePrefetch                 ()                                                              ;
+    std::span<const MenuTree::Node> menuLayer(int layer)              const                             ;
+    int  selectedItem                   (int layer)                   const                             ;
+    const MenuTree::Node* menuNode      (int layer, int item)         const                             ;
+    bool descendMenu                    (int layer, int item)                                           ;
+    bool ascendMenu                     ()                                                              ;
+    static MenuTree TESTgenerateMenu    (const std::vector<int>& branchingPerLevel)                     ;
 
 signals:
     void segmentClicked                 (int layer, int index)                                          ;
 
 private:
-    std::vector<MenuNode>                    m_menuRootNodes;
-    std::vector<std::vector<std::string>>       m_menuLayers;
+    std::shared_ptr<const MenuTree>                   m_menu;   // 构建后不再修改，与绘制线程共享
+    std::vector<MenuTree::Index>                m_menuLevels;   // 第 i 层显示该节点的子节点
+    std::vector<UsageStore::Key>             m_menuLevelKeys;   // 与 m_menuLevels 对应的菜单路径
+    std::vector<std::shared_ptr<const UsageStore::Order>> m_menuOrders;   // 与 m_menuLevels 对应的显示顺序
+    int                                          m_menuDepth;   // 第 0 层显示的菜单级数
+
+    static constexpr std::size_t MaxSearchResults = 256;
+    static constexpr int SearchPollInterval = 16;   // ms，索引建立期间检查是否完成的间隔
+    std::future<std::unique_ptr<MenuSearch>>   m_searchBuild;   // 第一次展开菜单时在后台建立
+    std::unique_ptr<MenuSearch>                     m_search;
+    QString                                    m_searchQuery;
+    std::shared_ptr<const std::vector<MenuTree::Index>> m_searchResults;   // 非空时第 0 层显示搜索结果，与绘制线程共享
+
+    static constexpr int UsageSaveDelay = 2000;   // ms
+    UsageStore                                       m_usage;
+    QString                                      m_usagePath;   // 为空时不记录
+    std::future<bool>                           m_usageWrite;
+    std::vector<std::uint32_t>                m_itemOrderSlots;   // 按父节点：0 未计算，1 菜单中的顺序，k + 2 为 m_itemOrders[k]
+    std::vector<std::shared_ptr<const UsageStore::Order>> m_itemOrders;   // 有使用记录的子菜单的显示顺序
+
+    int                                      m_prefetchLayer;
+    MenuTree::Index                         m_prefetchParent;
+    std::shared_ptr<const UsageStore::Order> m_prefetchOrder;
 
     double                              m_ballShrinkProgress;
 
-    QTimer*                                     m_hoverTimer;
+    QTimer*                                m_trailFadeTimer;
+    QTimer*                                m_usageSaveTimer;
+    QTimer*                               m_searchPollTimer;
 
     bool                                          m_expanded;
     bool                                          m_selected;
@@ -128,35 +238,57 @@ private:
     QPoint                                 m_centerGlobalPos;
     bool                                        m_isDragging;
 
-    std::vector<qreal>                        m_drawProgress;
-
     int                                       m_hoveredLayer;
     int                                       m_hoveredIndex;
     int                                   m_lastHoveredLayer;
-    std::vector<int>                      m_selectedSegments;
+    bool                                     m_hoverTracking;
+    bool                                        m_hoverStale;
+    QPoint                                        m_hoverPos;
+    int                                         m_wheelDelta;   // 不足一格的滚轮增量
+    std::vector<int>                      m_selectedSegments;   // 按菜单级数索引的选中条目
     bool                                      m_showSegments;
 
-    int                                         m_layerCount;
-    std::vector<double>                       m_layerSpacing;
-
-    std::vector<double>                         m_layerRadii;
-    std::vector<double>                  m_currentLayerRadii;
-    std::vector<int>                    m_layerSegmentCounts;
+    RadialLayout                                    m_layout;
     int                                       m_currentLayer;
     int                                 m_expandedLayerCount;
 
-    std::vector<double>                     m_layerOpacities;
-
-    std::vector<int>                              m_gapAngle;
     double                                     m_innerRadius;
 
     float                                  m_eyeOpenProgress;
 
     QPointF                                    m_jellyOffset;
     QPointF                                    m_lastDragPos;
-    QVariantAnimation*               m_jellyRestoreAnimation;
 
     DockDirection                            m_dockDirection;
 
     TrailPath                                        m_trail;
+    TrailMesh                                    m_trailMesh;
+    QRect                                 m_paintedTrailRect;
+
+    FrameProfiler                                 m_profiler;
+    bool                            m_profilerOverlayVisible;
+
+    bool                                    m_damageTracking;
+
+    FloatingBallRenderer                          m_renderer;
+    FloatingBallFrame                                m_frame;
+    std::uint64_t                            m_frameSequence;
+    FloatingBallFrame::Clock::time_point         m_inputTime;
+
+    std::unique_ptr<RenderThread>             m_renderThread;
+    QRegion                                  m_pendingDamage;
+    bool                                    m_frameScheduled;
+    std::uint64_t                            m_droppedFrames;
+
+    int                                       m_windowExtent;
+    ContentShape                              m_contentShape;
+
+    FrameClock                                  m_frameClock;
+    FrameClock::Tween                            m_ballTween;
+    FrameClock::Tween                             m_eyeTween;
+    FrameClock::Tween                           m_jellyTween;
+    FrameClock::Tween                            m_dockTween;
+    std::vector<FrameClock::Tween>            m_radiusTweens;
+    std::vector<FrameClock::Tween>              m_fadeTweens;
+    QRegion                                    m_frameDamage;
 };
\ No newline at end of file
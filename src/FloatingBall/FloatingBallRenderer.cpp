@@ -0,0 +1,419 @@
+#include "FloatingBallRenderer.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include <QFontMetrics>
+#include <QRadialGradient>
+
+// ======= 绘制 =======
+
+// painter 已经被裁剪到 frame.region；各绘制函数再跳过与该区域不相交的部分
+void FloatingBallRenderer::paint(QPainter& painter, const FloatingBallFrame& frame) {
+    // 持有旧树直到替换，标签 key（StringPool::Id）只在同一棵树内有意义
+    if (frame.menu != m_menu) {
+        m_menuLabels.clear();
+        m_menu = frame.menu;
+        m_prefetchedLayer = -1;
+    }
+
+    switch (frame.dock) {
+        case FloatingBallFrame::Dock::Vertical:
+            drawDockedVerticalCapsule(painter, frame);
+            return;
+        case FloatingBallFrame::Dock::Horizontal:
+            drawDockedHorizontalCapsule(painter, frame);
+            return;
+        case FloatingBallFrame::Dock::None:
+            break;
+    }
+
+    if (frame.ballShrinkProgress > 0.0) {
+        drawTrail(painter, frame);
+        if (frame.region.intersects(ballBounds(frame.rect().center(), frame.innerRadius))) drawBall(painter, frame);
+    }
+
+    if (frame.showSegments && frame.ballShrinkProgress <= 0.0) {
+        drawSegments(painter, frame);
+        prefetch(frame);
+    }
+}
+
+void FloatingBallRenderer::layoutRings(const FloatingBallFrame& frame) {
+    const QPointF center = frame.rect().center();
+    for (std::size_t layer = 0; layer < frame.layout.size(); ++layer) {
+        m_ringLayout.update(layer, center, frame.layout.innerRadius(layer, frame.innerRadius),
+                            frame.layout[layer], frame.layout.segments(layer));
+    }
+}
+
+QRect FloatingBallRenderer::ballBounds(const QPoint& center, double innerRadius) {
+    const int extent = static_cast<int>(std::ceil(innerRadius * 1.5 * 1.15)) + 2;
+    return {center.x() - extent, center.y() - extent, extent * 2, extent * 2};
+}
+
+// 球体的静态图层按 (量化半径, 选中, 拖动, 睁眼进度, dpr) 预渲染为精灵，每帧只做一次贴图 + 果冻形变；
+// 精灵按量化半径绘制，贴图时再缩放到实际半径。缓存未命中（首次出现的中间状态）时直接绘制
+void FloatingBallRenderer::drawBall(QPainter& painter, const FloatingBallFrame& frame) {
+    FrameProfiler::Scope scope(m_profiler, SectionBall);
+
+    QPoint center = frame.rect().center();
+    double r = frame.innerRadius * frame.ballShrinkProgress;
+
+    double scaleX = 1.0 - frame.jellyOffset.x() / (r * 2.0);
+    double scaleY = 1.0 - frame.jellyOffset.y() / (r * 2.0);
+    scaleX = std::clamp(scaleX, 0.85, 1.15);
+    scaleY = std::clamp(scaleY, 0.85, 1.15);
+
+    const qreal dpr = frame.dpr;
+    const double spriteRadius = std::max(std::round(r * BallRadiusSteps), 1.0) / BallRadiusSteps;
+    const float eyeOpen = std::round(frame.eyeOpenProgress * BallEyeSteps) / BallEyeSteps;
+
+    // 选中时的光晕半径为 1.5r；睁眼进度小于 -1 时眼睑曲线会超出球体
+    const double extent = spriteRadius * std::max(frame.selected ? 1.5 : 1.0, std::abs(1.0 - eyeOpen) * 0.5) + 1.0;
+    const int half = static_cast<int>(std::ceil(extent));
+
+    const QImage* sprite = m_ballSprites.get(
+        ballSpriteKey(spriteRadius, frame.selected, frame.dragging, eyeOpen, dpr),
+        QSize(half * 2, half * 2), dpr,
+        [&](QPainter& spritePainter) {
+            paintBall(spritePainter, QPointF(half, half), spriteRadius, frame.selected, frame.dragging, eyeOpen);
+        });
+
+    painter.save();
+    painter.translate(center);
+    painter.scale(scaleY, scaleX);
+
+    if (sprite) {
+        const double k = r / spriteRadius;
+        painter.scale(k, k);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.drawImage(QPointF(-half, -half), *sprite);
+    } else {
+        paintBall(painter, QPointF(), r, frame.selected, frame.dragging, frame.eyeOpenProgress);
+    }
+
+    painter.restore();
+}
+
+void FloatingBallRenderer::paintBall(QPainter& painter, const QPointF& center, double r, bool selected, bool dragging, float eyeOpenProgress) {
+    QRadialGradient gradient;
+    gradient.setCenter(center);
+    gradient.setFocalPoint(center.x() - r * 0.3, center.y() - r * 0.3);
+    gradient.setRadius(r);
+
+    gradient.setColorAt(0.0, QColor(141,196,253, 200));
+    gradient.setColorAt(1.0, QColor(141,196,253, 140));
+
+    QRectF ellipseRect(
+        center.x() - r,
+        center.y() - r,
+        r * 2,
+        r * 2
+    );
+
+    double middleRadius = r * 0.5;
+    double middleInnerRadius = middleRadius * 0.7;
+
+    QRectF middleRect(
+        center.x() - middleRadius,
+        center.y() - middleRadius,
+        middleRadius * 2,
+        middleRadius * 2
+    );
+
+    QRectF middleInnerRect(
+        center.x() - middleInnerRadius,
+        center.y() - middleInnerRadius,
+        middleInnerRadius * 2,
+        middleInnerRadius * 2
+    );
+
+    QPainterPath middlePath, middleInnerPath;
+    middlePath.addEllipse(middleRect);
+    middleInnerPath.addEllipse(middleInnerRect);
+    middlePath = middlePath.subtracted(middleInnerPath);
+
+    QColor middleColor = QColor(178,219,251, 200);
+
+    double innerRadius = r * 0.3;
+    QRectF innerCircle(
+        center.x() - innerRadius,
+        center.y() - innerRadius,
+        innerRadius * 2,
+        innerRadius * 2
+    );
+
+    QColor innerColor = QColor(124,164,223, 220);
+
+    if (dragging) {
+        painter.setBrush(QColor(0,0,0,255));
+        painter.drawEllipse(ellipseRect);
+    }
+
+    painter.setBrush(gradient);
+    painter.setPen(Qt::NoPen);
+    painter.drawEllipse(ellipseRect);
+    painter.setBrush(middleColor);
+    painter.drawPath(middlePath);
+    painter.setBrush(innerColor);
+    painter.drawEllipse(innerCircle);
+
+    if (selected) {
+        QRadialGradient glowGradient;
+        glowGradient.setCenter(center);
+        glowGradient.setFocalPoint(center);
+        glowGradient.setRadius(r * 1.5);
+
+        glowGradient.setColorAt(0.0, QColor(209,248,255, 100));
+        glowGradient.setColorAt(0.7, QColor(209,248,255, 30));
+        glowGradient.setColorAt(1.0, QColor(209,248,255, 0));
+
+        painter.setBrush(glowGradient);
+        painter.setPen(Qt::NoPen);
+
+        QRectF glowRect(
+            center.x() - r * 1.5,
+            center.y() - r * 1.5,
+            r * 3.0,
+            r * 3.0
+        );
+
+        painter.drawEllipse(glowRect);
+    }
+
+    QPainterPath lowerMask, upperMask;
+
+    qreal offset = r * (1.0 - eyeOpenProgress);
+
+    QRectF arcRect(center.x() - r, center.y() - r, r * 2, r * 2);
+    QPointF lowerEyeCenter(center.x(), center.y() + offset);
+    QPointF upperEyeCenter(center.x(), center.y() - offset);
+
+    QPointF startLowerPoint(center.x() - r, center.y());
+    QPointF endLowerPoint(center.x() + r, center.y());
+
+    lowerMask.moveTo(startLowerPoint);
+    lowerMask.quadTo(lowerEyeCenter, endLowerPoint);
+    lowerMask.arcTo(arcRect, 0, -180);
+
+    if (selected) {
+        gradient.setColorAt(0.0, QColor(220, 220, 220, 255));
+        gradient.setColorAt(1.0, QColor(180, 180, 180, 255));
+    } else {
+        gradient.setColorAt(0.0, QColor(150, 150, 150, 255));
+        gradient.setColorAt(1.0, QColor(100, 100, 100, 255));
+    }
+
+    painter.setBrush(gradient);
+    painter.setPen(Qt::NoPen);
+    painter.drawPath(lowerMask);
+
+    upperMask.moveTo(startLowerPoint);
+    upperMask.arcTo(arcRect, 180, -180);
+    upperMask.quadTo(upperEyeCenter, startLowerPoint);
+    painter.drawPath(upperMask);
+}
+
+// 半径 24 位 | 睁眼进度 16 位 | 选中 1 位 | 拖动 1 位 | dpr 16 位
+std::uint64_t FloatingBallRenderer::ballSpriteKey(double spriteRadius, bool selected, bool dragging, float eyeOpen, qreal dpr) {
+    const auto radiusSteps = static_cast<std::uint64_t>(std::lround(spriteRadius * BallRadiusSteps)) & 0xFFFFFF;
+    const auto eyeSteps    = static_cast<std::uint64_t>(std::clamp(std::lround((eyeOpen + 4.0f) * BallEyeSteps), 0L, 0xFFFFL));
+    const auto dprSteps    = static_cast<std::uint64_t>(std::clamp(std::lround(dpr * 100.0), 1L, 0xFFFFL));
+
+    return radiusSteps
+         | (eyeSteps << 24)
+         | (static_cast<std::uint64_t>(selected) << 40)
+         | (static_cast<std::uint64_t>(dragging) << 41)
+         | (dprSteps << 42);
+}
+
+void FloatingBallRenderer::drawSegments(QPainter& painter, const FloatingBallFrame& frame) {
+    FrameProfiler::Scope scope(m_profiler, SectionSegments);
+
+    layoutRings(frame);
+
+    for (int layer = 0; layer < static_cast<int>(frame.layout.size()); ++layer) {
+        const RingLayout::Layer& geometry = *m_ringLayout.find(layer);
+        if (!frame.region.intersects(geometry.bounds)) continue;
+
+        const double layerOpacity = frame.layout[layer].opacity;
+        const int firstItem = frame.layout[layer].firstItem;
+        const std::span<const MenuTree::Node> items = (frame.menu && layer < frame.menuLevels.size())
+                                                    ? frame.menu->children(frame.menuLevels[layer])
+                                                    : std::span<const MenuTree::Node>();
+        const std::vector<MenuTree::Index>* results = layer == 0 ? frame.searchResults.get() : nullptr;
+        const UsageStore::Order* order = layer < frame.menuOrders.size() ? frame.menuOrders[layer].get() : nullptr;
+        QColor textColor = Qt::white;
+        textColor.setAlphaF(layerOpacity);
+
+        for (int i = 0; i < static_cast<int>(geometry.segments.size()); ++i) {
+            if (!frame.region.intersects(geometry.segments[i].bounds)) continue;
+
+            QColor color;
+            const int item = firstItem + i;
+
+            if (layer == frame.hoveredLayer && i == frame.hoveredIndex) {
+                color = QColor(255, 0, 0, 180);
+            } else if (frame.selectedSegments.size() > layer && frame.selectedSegments[layer] == item) {
+                color = QColor(180, 180, 180, 140);
+            } else {
+                color = QColor(100, 100, 100, 140);
+            }
+
+            int baseAlpha = color.alpha();
+            color.setAlphaF((baseAlpha / 255.0) * layerOpacity);
+
+            painter.setBrush(color);
+            painter.setPen(Qt::NoPen);
+            painter.drawPath(geometry.segments[i].path);
+
+            painter.setPen(textColor);
+            const MenuTree::Node* node = nullptr;
+            if (results) {
+                if (static_cast<std::size_t>(item) < results->size() && frame.menu) node = &(*frame.menu)[(*results)[item]];
+            } else if (static_cast<std::size_t>(item) < items.size()) {
+                node = &items[order ? order->items[item] : item];
+            }
+            const QStaticText& label = node ? m_menuLabels.at(node->label, frame.menu->label(*node)) : m_menuLabels.fallback();
+            m_menuLabels.paint(painter, label, geometry.segments[i].label);
+        }
+    }
+
+    if (!frame.searchQuery.isEmpty()) drawSearchQuery(painter, frame);
+}
+
+// 同一层同一父节点只预取一次；标签缓存与几何缓存都在本实例中，所以同步绘制与后台绘制各自预取
+void FloatingBallRenderer::prefetch(const FloatingBallFrame& frame) {
+    const int layer = frame.prefetchLayer;
+    if (layer < 0 || layer >= static_cast<int>(frame.layout.size()) || !frame.menu) return;
+    if (layer == m_prefetchedLayer && frame.prefetchParent == m_prefetchedParent) return;
+    m_prefetchedLayer = layer;
+    m_prefetchedParent = frame.prefetchParent;
+
+    const RadialLayout::Layer& spec = frame.layout[layer];
+    m_ringLayout.prepare(layer, frame.rect().center(), frame.layout.restingInnerRadius(layer, frame.innerRadius),
+                         spec, frame.layout.segments(layer));
+
+    // 新展开的子菜单窗口从第一个条目开始
+    const std::span<const MenuTree::Node> items = frame.menu->children(frame.prefetchParent);
+    const UsageStore::Order* order = frame.prefetchOrder.get();
+    const std::size_t count = std::min(items.size(), static_cast<std::size_t>(spec.segmentCount));
+    for (std::size_t k = 0; k < count; ++k) {
+        const MenuTree::Node& node = items[order ? order->items[k] : k];
+        (void)m_menuLabels.at(node.label, frame.menu->label(node));
+    }
+}
+
+// 搜索词显示在中心（球体已收起），过长时保留末尾
+void FloatingBallRenderer::drawSearchQuery(QPainter& painter, const FloatingBallFrame& frame) {
+    const QRect bounds = ballBounds(frame.rect().center(), frame.innerRadius);
+    if (!frame.region.intersects(bounds)) return;
+
+    const QFontMetrics metrics(m_menuLabels.font());
+    const int width = static_cast<int>(frame.innerRadius * 2.0);
+    const QString text = metrics.elidedText(frame.searchQuery, Qt::ElideLeft, width);
+
+    painter.setFont(m_menuLabels.font());
+    painter.setPen(Qt::white);
+    painter.drawText(bounds, Qt::AlignCenter, text);
+}
+
+
+void FloatingBallRenderer::drawDockedVerticalCapsule(QPainter &painter, const FloatingBallFrame& frame) {
+    FrameProfiler::Scope scope(m_profiler, SectionVerticalCapsule);
+
+    QPoint center = frame.rect().center();
+
+    constexpr int capsuleWidth = 20;
+    constexpr int capsuleHeight = 60;
+    constexpr int radius = capsuleWidth / 2;
+
+    QRectF topArcRect(
+        center.x() - radius,
+        center.y() - capsuleHeight / 2,
+        capsuleWidth,
+        capsuleWidth
+    );
+
+    QRectF bottomArcRect(
+        center.x() - radius,
+        center.y() + capsuleHeight / 2 - capsuleWidth,
+        capsuleWidth,
+        capsuleWidth
+    );
+
+    QPainterPath path;
+
+    path.moveTo(bottomArcRect.left(), bottomArcRect.center().y());
+
+    path.arcTo(bottomArcRect, 180, 180);
+
+    path.lineTo(topArcRect.right(), topArcRect.center().y());
+
+    path.arcTo(topArcRect, 0, 180);
+
+    path.lineTo(bottomArcRect.left(), bottomArcRect.center().y());
+
+    path.closeSubpath();
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(QColor(220, 220, 220, 200));
+    painter.setPen(Qt::NoPen);
+    painter.drawPath(path);
+}
+
+
+void FloatingBallRenderer::drawDockedHorizontalCapsule(QPainter &painter, const FloatingBallFrame& frame) {
+    FrameProfiler::Scope scope(m_profiler, SectionHorizontalCapsule);
+
+    QPoint center = frame.rect().center();
+
+    constexpr int capsuleWidth = 60;
+    constexpr int capsuleHeight = 20;
+    constexpr int radius = capsuleHeight / 2;
+
+    QRectF leftArcRect(
+        center.x() - capsuleWidth / 2,
+        center.y() - radius,
+        capsuleHeight,
+        capsuleHeight
+    );
+
+    QRectF rightArcRect(
+        center.x() + capsuleWidth / 2 - capsuleHeight,
+        center.y() - radius,
+        capsuleHeight,
+        capsuleHeight
+    );
+
+    QPainterPath path;
+
+    path.moveTo(leftArcRect.center());
+
+    path.arcTo(leftArcRect, 90, 180);
+
+    path.lineTo(rightArcRect.left(), rightArcRect.bottom());
+
+    path.arcTo(rightArcRect, 270, 180);
+
+    path.lineTo(leftArcRect.right() - radius, leftArcRect.top());
+
+    path.closeSubpath();
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(QColor(220, 220, 220, 200));
+    painter.setPen(Qt::NoPen);
+    painter.drawPath(path);
+}
+
+
+// 顶点由 GUI 线程生成（TrailPath 不能跨线程读取），不与重绘区域相交时为空
+void FloatingBallRenderer::drawTrail(QPainter &painter, const FloatingBallFrame& frame) {
+    FrameProfiler::Scope scope(m_profiler, SectionTrail);
+
+    if (frame.trail.empty()) return;
+
+    m_trailMesh.assign(frame.trail);
+    m_trailMesh.paint(painter, QColor(141,196,233));
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include <QSize>
+#include <QRect>
+#include <QRegion>
+#include <QPointF>
+#include <QPainter>
+#include <QString>
+
+#include "../core/draw/Trail/TrailMesh.h"
+#include "../core/draw/Sprite/SpriteCache.h"
+#include "../core/draw/Ring/RadialLayout.h"
+#include "../core/draw/Ring/RingLayout.h"
+#include "../core/draw/Text/LabelCache.h"
+#include "../core/menu/MenuTree.h"
+#include "../core/menu/UsageStore.h"
+#include "../core/profile/FrameProfiler.h"
+
+// 一帧绘制所需的全部输入：由 GUI 线程从 FloatingBall 的状态生成，绘制期间只读。
+// 同步绘制时在 paintEvent 中生成并直接绘制；后台绘制时复制给工作线程
+struct FloatingBallFrame {
+    using Clock = std::chrono::steady_clock;
+
+    enum class Dock {
+        None,
+        Vertical,
+        Horizontal
+    };
+
+    QSize                               size;
+    qreal                               dpr                = 1.0;
+    QRegion                             region;                      // 需要绘制的区域，之外的部分可以跳过
+
+    Dock                                dock               = Dock::None;
+
+    double                              innerRadius        = 0.0;
+    double                              ballShrinkProgress = 1.0;
+    QPointF                             jellyOffset;
+    float                               eyeOpenProgress    = 1.0f;
+    bool                                selected           = false;
+    bool                                dragging           = false;
+
+    bool                                showSegments       = false;
+    RadialLayout                        layout;
+    std::vector<int>                    selectedSegments;            // 每层选中的条目（不是扇区），-1 为未选中
+    int                                 hoveredLayer       = -1;
+    int                                 hoveredIndex       = -1;     // 扇区下标
+
+    std::shared_ptr<const MenuTree>     menu;                        // 构建后不再修改，GUI 线程更换菜单时整体替换
+    std::vector<MenuTree::Index>        menuLevels;                  // 第 i 层显示 menu 中该节点的子节点
+    std::vector<std::shared_ptr<const UsageStore::Order>> menuOrders; // 第 i 层条目的显示顺序，nullptr 为菜单中的顺序
+    std::shared_ptr<const std::vector<MenuTree::Index>> searchResults; // 非空时第 0 层依次显示这些节点
+    QString                             searchQuery;                 // 非空时显示在中心
+
+    // 下一步最可能展开的层：第 prefetchLayer 层将显示 prefetchParent 的子节点，绘制后预先排版其第一页标签并构建该层的几何
+    int                                 prefetchLayer      = -1;
+    MenuTree::Index                     prefetchParent     = MenuTree::Root;
+    std::shared_ptr<const UsageStore::Order> prefetchOrder;
+
+    std::vector<TrailMesh::Vertex>      trail;                       // 已换算到窗口坐标
+
+    std::uint64_t                       sequence           = 0;
+    Clock::time_point                   inputTime{};                 // 本帧包含的最早一次未绘制的输入，没有输入时为默认值
+
+    [[nodiscard]] QRect rect() const { return {QPoint(), size}; }
+};
+
+// 按 FloatingBallFrame 绘制球体、菜单扇区、拖尾与停靠胶囊，持有各自的几何 / 精灵 / 文本缓存。
+// 不访问 FloatingBall，同一份代码既用于 GUI 线程的同步绘制，也用于工作线程的后台绘制（各自一个实例）
+class FloatingBallRenderer {
+public:
+    enum Section : std::uint32_t {
+        SectionTrail,
+        SectionBall,
+        SectionSegments,
+        SectionVerticalCapsule,
+        SectionHorizontalCapsule
+    };
+
+    // 球体精灵的量化步长：半径 1/4 像素，睁眼进度 1/64
+    static constexpr double BallRadiusSteps = 4.0;
+    static constexpr float  BallEyeSteps    = 64.0f;
+
+    // 区段与 Section 一一对应的计时器
+    [[nodiscard]] static FrameProfiler makeProfiler() {
+        return FrameProfiler({"drawTrail", "drawBall", "drawSegments", "drawDockedVerticalCapsule", "drawDockedHorizontalCapsule"});
+    }
+
+    explicit FloatingBallRenderer(FrameProfiler& profiler)
+        : m_profiler(profiler), m_menuLabels(QFont("Arial", 10)) {}
+
+    void paint(QPainter& painter, const FloatingBallFrame& frame);
+
+    // 更新所有层的扇区几何（已缓存的层不会重建）；绘制扇区前调用，也用于在不绘制时保持重绘区域计算所需的几何
+    void layoutRings(const FloatingBallFrame& frame);
+
+    // 球体在任何状态下（选中光晕 1.5r、果冻形变最多放大 1.15 倍、停靠胶囊）都不超出这个矩形
+    [[nodiscard]] static QRect ballBounds(const QPoint& center, double innerRadius);
+
+    [[nodiscard]] auto ringLayout()  const -> const RingLayout& { return m_ringLayout; }
+    [[nodiscard]] auto spriteCache()       -> SpriteCache&      { return m_ballSprites; }
+
+    // 菜单标签与搜索框的字体；更换后已排版的标签全部重新排版
+    [[nodiscard]] auto labelFont()   const -> const QFont&      { return m_menuLabels.font(); }
+    void setLabelFont(const QFont& font)                        { m_menuLabels.setFont(font); }
+
+private:
+    void drawBall                       (QPainter& painter, const FloatingBallFrame& frame)             ;
+    void drawSegments                   (QPainter& painter, const FloatingBallFrame& frame)             ;
+    void drawDockedVerticalCapsule      (QPainter& painter, const FloatingBallFrame& frame)             ;
+    void drawDockedHorizontalCapsule    (QPainter& painter, const FloatingBallFrame& frame)             ;
+    void drawTrail                      (QPainter& painter, const FloatingBallFrame& frame)             ;
+    void drawSearchQuery                (QPainter& painter, const FloatingBallFrame& frame)             ;
+    void prefetch                       (const FloatingBallFrame& frame)                                ;
+
+    static void paintBall               (QPainter& painter, const QPointF& center, double r,
+                                         bool selected, bool dragging, float eyeOpenProgress)           ;
+    static std::uint64_t ballSpriteKey  (double spriteRadius, bool selected, bool dragging,
+                                         float eyeOpen, qreal dpr)                                      ;
+
+    FrameProfiler&                                  m_profiler;
+
+    SpriteCache                                  m_ballSprites;
+    RingLayout                                    m_ringLayout;
+    LabelCache                                    m_menuLabels;
+    std::shared_ptr<const MenuTree>               m_menu;   // m_menuLabels 的 key 所属的菜单树
+    int                                  m_prefetchedLayer = -1;
+    MenuTree::Index                     m_prefetchedParent = MenuTree::Root;
+    TrailMesh                                      m_trailMesh;
+};
@@ -0,0 +1,135 @@
+#ifndef FRAMECLOCK_H
+#define FRAMECLOCK_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include <QTimer>
+#include <QScreen>
+#include <QEasingCurve>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+
+// 所有补间共用的帧时钟：补间保存在一个扁平数组里，每次显示刷新推进一次全部活动的补间，
+// 推进完成后调用一次 onFrame（调用方在这里合并本帧的重绘请求），没有活动补间时定时器停止。
+//
+// Qt Widgets 没有公开的垂直同步回调，所以时钟以屏幕刷新间隔的 PreciseTimer 触发，
+// 补间进度按 QElapsedTimer 的实际时间计算，定时器抖动只影响采样时刻，不影响动画速度。
+//
+// 补间槽位由 add() 一次性分配，之后的每次 start() 都复用同一个槽位（包括其中的 QEasingCurve），
+// 重新 start() 一个正在运行的补间会从当前时刻重新开始，不会与旧的补间并存。
+class FrameClock {
+public:
+    // 补间句柄：槽位下标，add() 之后一直有效
+    struct Tween {
+        std::uint32_t index = UINT32_MAX;
+        [[nodiscard]] bool valid() const { return index != UINT32_MAX; }
+    };
+
+    // update 接收经过缓动的进度 [0, 1]（OutElastic 等曲线会超出该范围）
+    using Update   = std::function<void(qreal)>;
+    using Finished = std::function<void()>;
+
+    explicit FrameClock(std::function<void()> onFrame = {}) : m_onFrame(std::move(onFrame)) {
+        m_timer.setTimerType(Qt::PreciseTimer);
+        QObject::connect(&m_timer, &QTimer::timeout, [this]() { tick(); });
+        m_elapsed.start();
+    }
+
+    FrameClock(const FrameClock&) = delete;
+    FrameClock& operator=(const FrameClock&) = delete;
+
+    void setOnFrame(std::function<void()> onFrame) { m_onFrame = std::move(onFrame); }
+
+    [[nodiscard]] Tween add() {
+        m_slots.emplace_back();
+        return {static_cast<std::uint32_t>(m_slots.size() - 1)};
+    }
+
+    void start(Tween tween, int durationMs, QEasingCurve::Type easing, Update update, Finished finished = {}) {
+        Slot& slot = m_slots[tween.index];
+        slot.startMs    = m_elapsed.elapsed();
+        slot.durationMs = std::max(durationMs, 1);
+        slot.easing.setType(easing);
+        slot.update     = std::move(update);
+        slot.finished   = std::move(finished);
+        ++slot.generation;
+
+        if (!slot.active) {
+            slot.active = true;
+            ++m_active;
+        }
+        if (!m_timer.isActive()) {
+            m_timer.start(frameIntervalMs());
+        }
+    }
+
+    // 停止时不调用 finished
+    void stop(Tween tween) {
+        Slot& slot = m_slots[tween.index];
+        if (!slot.active) return;
+        slot.active = false;
+        ++slot.generation;
+        --m_active;
+    }
+
+    [[nodiscard]] bool isActive(Tween tween) const { return tween.valid() && m_slots[tween.index].active; }
+    [[nodiscard]] auto activeCount() const -> std::uint32_t { return m_active; }
+    [[nodiscard]] auto frames()      const -> std::uint64_t { return m_frames; }
+
+    // 推进所有活动的补间；finished 中可以 start() 其他补间（包括自身），新开始的补间从下一帧开始推进
+    void tick() {
+        const qint64 now = m_elapsed.elapsed();
+
+        for (std::size_t i = 0; i < m_slots.size(); ++i) {
+            if (!m_slots[i].active || m_slots[i].startMs == now) continue;
+
+            Slot& slot = m_slots[i];
+            const qreal t = std::clamp(static_cast<qreal>(now - slot.startMs) / slot.durationMs, 0.0, 1.0);
+            const std::uint32_t generation = slot.generation;
+            slot.update(slot.easing.valueForProgress(t));
+
+            // update 中可能 stop / 重新 start 了本补间
+            if (t < 1.0 || m_slots[i].generation != generation) continue;
+
+            m_slots[i].active = false;
+            --m_active;
+            if (Finished finished = std::move(m_slots[i].finished)) finished();
+        }
+
+        ++m_frames;
+        if (m_onFrame) m_onFrame();
+        if (m_active == 0) m_timer.stop();
+    }
+
+private:
+    struct Slot {
+        bool            active     = false;
+        std::uint32_t   generation = 0;
+        qint64          startMs    = 0;
+        int             durationMs = 1;
+        QEasingCurve    easing;
+        Update          update;
+        Finished        finished;
+    };
+
+    // 按主屏刷新率取帧间隔，取不到时按 60 Hz
+    [[nodiscard]] static int frameIntervalMs() {
+        const QScreen* screen = QGuiApplication::primaryScreen();
+        const qreal hz = screen ? screen->refreshRate() : 60.0;
+        return std::max(1, static_cast<int>(1000.0 / (hz > 1.0 ? hz : 60.0)));
+    }
+
+    std::vector<Slot>       m_slots;
+    std::uint32_t           m_active = 0;
+    std::uint64_t           m_frames = 0;
+    std::function<void()>   m_onFrame;
+    QTimer                  m_timer;
+    QElapsedTimer           m_elapsed;
+};
+
+#endif //FRAMECLOCK_H
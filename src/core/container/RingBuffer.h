@@ -0,0 +1,143 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+// 固定容量环形缓冲区：构造后不再分配内存，push / popFront 均为 O(1)。
+// 满时 push 会覆盖最旧的元素；逻辑下标 0 始终是最旧的元素。
+template <typename Ty_>
+class RingBuffer {
+public:
+    template <bool Const>
+    class Iterator {
+        using Owner = std::conditional_t<Const, const RingBuffer, RingBuffer>;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = Ty_;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::conditional_t<Const, const Ty_&, Ty_&>;
+        using pointer           = std::conditional_t<Const, const Ty_*, Ty_*>;
+
+        Iterator() = default;
+        Iterator(Owner* owner, std::size_t index) : m_owner(owner), m_index(index) {}
+
+        reference operator*()                        const { return (*m_owner)[m_index];  }
+        pointer   operator->()                       const { return &(*m_owner)[m_index]; }
+        reference operator[](difference_type n)      const { return (*m_owner)[m_index + n]; }
+
+        Iterator& operator++()                             { ++m_index; return *this; }
+        Iterator  operator++(int)                          { Iterator t = *this; ++m_index; return t; }
+        Iterator& operator--()                             { --m_index; return *this; }
+        Iterator  operator--(int)                          { Iterator t = *this; --m_index; return t; }
+        Iterator& operator+=(difference_type n)            { m_index += n; return *this; }
+        Iterator& operator-=(difference_type n)            { m_index -= n; return *this; }
+
+        friend Iterator operator+(Iterator it, difference_type n)       { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it)       { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n)       { return it -= n; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b) {
+            return static_cast<difference_type>(a.m_index) - static_cast<difference_type>(b.m_index);
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b)    { return a.m_index == b.m_index; }
+        friend auto operator<=>(const Iterator& a, const Iterator& b)   { return a.m_index <=> b.m_index; }
+
+    private:
+        Owner*      m_owner = nullptr;
+        std::size_t m_index = 0;
+    };
+
+    using iterator       = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit RingBuffer(std::size_t capacity) : m_storage(std::max<std::size_t>(capacity, 1)) {}
+
+    [[nodiscard]] auto size()     const -> std::size_t { return m_size;                       }
+    [[nodiscard]] auto capacity() const -> std::size_t { return m_storage.size();             }
+    [[nodiscard]] bool empty()    const                { return m_size == 0;                  }
+    [[nodiscard]] bool full()     const                { return m_size == m_storage.size();   }
+
+    void clear() { m_head = 0; m_size = 0; }
+
+    // 修改容量会重新分配一次存储，保留最新的 min(size, capacity) 个元素
+    void setCapacity(std::size_t capacity) {
+        capacity = std::max<std::size_t>(capacity, 1);
+        if (capacity == m_storage.size()) return;
+
+        std::vector<Ty_> storage(capacity);
+        const std::size_t keep = std::min(m_size, capacity);
+        for (std::size_t i = 0; i < keep; ++i) {
+            storage[i] = std::move((*this)[m_size - keep + i]);
+        }
+
+        m_storage = std::move(storage);
+        m_head = 0;
+        m_size = keep;
+    }
+
+    // 满时覆盖最旧元素，返回是否发生了覆盖
+    template <typename... Args>
+    bool push(Args&&... args) {
+        const bool evicted = full();
+        m_storage[physical(m_size)] = Ty_(std::forward<Args>(args)...);
+        if (evicted) {
+            m_head = wrap(m_head + 1);
+        } else {
+            ++m_size;
+        }
+        return evicted;
+    }
+
+    void popFront() {
+        if (m_size == 0) return;
+        m_head = wrap(m_head + 1);
+        --m_size;
+    }
+
+    void popBack() {
+        if (m_size == 0) return;
+        --m_size;
+    }
+
+    [[nodiscard]] Ty_&       operator[](std::size_t i)       { return m_storage[physical(i)]; }
+    [[nodiscard]] const Ty_& operator[](std::size_t i) const { return m_storage[physical(i)]; }
+
+    [[nodiscard]] Ty_&       front()       { return (*this)[0];          }
+    [[nodiscard]] const Ty_& front() const { return (*this)[0];          }
+    [[nodiscard]] Ty_&       back()        { return (*this)[m_size - 1]; }
+    [[nodiscard]] const Ty_& back()  const { return (*this)[m_size - 1]; }
+
+    [[nodiscard]] iterator       begin()        { return {this, 0};      }
+    [[nodiscard]] iterator       end()          { return {this, m_size}; }
+    [[nodiscard]] const_iterator begin()  const { return {this, 0};      }
+    [[nodiscard]] const_iterator end()    const { return {this, m_size}; }
+
+    // 按物理顺序返回两段连续内存（旧 -> 新），用于无拷贝的批量遍历
+    [[nodiscard]] auto spans() const -> std::pair<std::span<const Ty_>, std::span<const Ty_>> {
+        const std::size_t firstLen = std::min(m_size, m_storage.size() - m_head);
+        return {
+            std::span<const Ty_>(m_storage.data() + m_head, firstLen),
+            std::span<const Ty_>(m_storage.data(), m_size - firstLen)
+        };
+    }
+
+private:
+    [[nodiscard]] std::size_t wrap(std::size_t i) const {
+        return i >= m_storage.size() ? i - m_storage.size() : i;
+    }
+
+    [[nodiscard]] std::size_t physical(std::size_t i) const {
+        return wrap(m_head + i);
+    }
+
+    std::vector<Ty_> m_storage;
+    std::size_t      m_head = 0;
+    std::size_t      m_size = 0;
+};
+
+#endif //RINGBUFFER_H
@@ -0,0 +1,87 @@
+#ifndef SOARING_H
+#define SOARING_H
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// 多列 float 的镜像环形缓冲（SoA）。每列长度为 2 * capacity，写入时同时写 i 和 i + capacity，
+// 因此任意时刻 [0, size) 的每一列在内存中都是连续的，可以直接交给 SIMD 代码。
+// 构造 / setCapacity 之外不分配内存；pushRow / popFront 为 O(1)。
+template <std::size_t Columns>
+class SoARing {
+public:
+    explicit SoARing(std::size_t capacity) { setCapacity(capacity); }
+
+    [[nodiscard]] auto size()     const -> std::size_t { return m_size;     }
+    [[nodiscard]] auto capacity() const -> std::size_t { return m_capacity; }
+    [[nodiscard]] bool empty()    const                { return m_size == 0; }
+    [[nodiscard]] bool full()     const                { return m_size == m_capacity; }
+
+    void clear() { m_head = 0; m_size = 0; }
+
+    // 修改容量会重新分配一次存储，保留最新的 min(size, capacity) 行
+    void setCapacity(std::size_t capacity) {
+        capacity = std::max<std::size_t>(capacity, 1);
+        if (capacity == m_capacity) return;
+
+        const std::size_t keep = std::min(m_size, capacity);
+        for (auto& column : m_columns) {
+            std::vector<float> resized(capacity * 2);
+            for (std::size_t i = 0; i < keep; ++i) {
+                resized[i] = resized[i + capacity] = column[m_head + m_size - keep + i];
+            }
+            column = std::move(resized);
+        }
+
+        m_capacity = capacity;
+        m_head = 0;
+        m_size = keep;
+    }
+
+    // 追加一行（满时覆盖最旧的一行），返回是否发生了覆盖。新行的内容需随后通过 set 写入
+    bool pushRow() {
+        const bool evicted = full();
+        if (evicted) {
+            m_head = (m_head + 1) % m_capacity;
+        } else {
+            ++m_size;
+        }
+        return evicted;
+    }
+
+    void popFront() {
+        if (m_size == 0) return;
+        m_head = (m_head + 1) % m_capacity;
+        --m_size;
+    }
+
+    void popBack() {
+        if (m_size == 0) return;
+        --m_size;
+    }
+
+    void set(std::size_t column, std::size_t row, float value) {
+        const std::size_t slot = (m_head + row) % m_capacity;
+        m_columns[column][slot] = m_columns[column][slot + m_capacity] = value;
+    }
+
+    [[nodiscard]] float get(std::size_t column, std::size_t row) const {
+        return m_columns[column][m_head + row];
+    }
+
+    // 指向最旧一行的连续数组，长度为 size()
+    [[nodiscard]] const float* column(std::size_t column) const {
+        return m_columns[column].data() + m_head;
+    }
+
+private:
+    std::array<std::vector<float>, Columns> m_columns;
+
+    std::size_t m_capacity = 0;
+    std::size_t m_head     = 0;
+    std::size_t m_size     = 0;
+};
+
+#endif //SOARING_H
@@ -0,0 +1,85 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+
+// 字符串驻留池：相同内容只保存一份，以 32 位 Id 引用。
+// 字符数据按 64 KiB 的块追加分配，块不会移动，所以 view() 返回的 string_view 在池的生命周期内一直有效，
+// 查找表的键也直接引用块内的数据。Id 0 固定为空字符串。
+class StringPool {
+public:
+    using Id = std::uint32_t;
+
+    static constexpr std::size_t BlockSize = 64 * 1024;
+
+    StringPool() { intern({}); }
+
+    StringPool(StringPool&&) noexcept = default;
+    StringPool& operator=(StringPool&&) noexcept = default;
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    Id intern(std::string_view text) {
+        if (auto it = m_ids.find(text); it != m_ids.end()) return it->second;
+
+        const std::string_view stored = store(text);
+        const auto id = static_cast<Id>(m_strings.size());
+        m_strings.push_back(stored);
+        m_ids.emplace(stored, id);
+        return id;
+    }
+
+    [[nodiscard]] std::string_view view(Id id) const { return m_strings[id]; }
+
+    [[nodiscard]] auto size() const -> std::size_t { return m_strings.size(); }
+
+    // 堆内存的估计值：字符块 + Id 表 + 查找表（桶数组与每个节点）
+    [[nodiscard]] std::size_t memoryUsage() const {
+        constexpr std::size_t hashNode = sizeof(void*) + sizeof(std::size_t) + sizeof(std::pair<const std::string_view, Id>);
+        return m_blockBytes
+             + m_strings.capacity() * sizeof(std::string_view)
+             + m_ids.bucket_count() * sizeof(void*)
+             + m_ids.size() * hashNode;
+    }
+
+private:
+    std::string_view store(std::string_view text) {
+        if (text.empty()) return {};
+
+        // 超过一块的字符串单独分配，不打断当前块（也不会成为当前块，所以下面以 m_current 判断是否已有当前块）
+        if (text.size() > BlockSize) {
+            auto& block = m_blocks.emplace_back(std::make_unique<char[]>(text.size()));
+            m_blockBytes += text.size();
+            std::memcpy(block.get(), text.data(), text.size());
+            return {block.get(), text.size()};
+        }
+
+        if (m_current == nullptr || BlockSize - m_used < text.size()) {
+            m_current = m_blocks.emplace_back(std::make_unique<char[]>(BlockSize)).get();
+            m_blockBytes += BlockSize;
+            m_used = 0;
+        }
+
+        char* data = m_current + m_used;
+        std::memcpy(data, text.data(), text.size());
+        m_used += text.size();
+        return {data, text.size()};
+    }
+
+    std::vector<std::unique_ptr<char[]>>            m_blocks;
+    char*                                           m_current    = nullptr;
+    std::size_t                                     m_used       = 0;
+    std::size_t                                     m_blockBytes = 0;
+
+    std::vector<std::string_view>                   m_strings;
+    std::unordered_map<std::string_view, Id>        m_ids;
+};
+
+#endif //STRINGPOOL_H
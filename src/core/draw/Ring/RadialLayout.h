@@ -0,0 +1,226 @@
+#ifndef RADIALLAYOUT_H
+#define RADIALLAYOUT_H
+
+#include <bit>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#include "../../../ext/math/math.h"
+
+// 径向菜单的层表：每层的配置（目标半径、间距、扇区数、间隔角）与动画状态（当前半径、展开进度、透明度）
+// 放在同一个结构里，所有层的扇区（起始角、标签方向的 cos / sin）放在一张扁平的扇区表里。
+// 扇区表只在扇区数或间隔变化时重建，绘制（RingLayout）与悬停判定都只读取这两张表，内存只随层数与扇区总数变化。
+//
+// 悬停判定为 O(1)：按整数半径索引的层掩码表给出与该 1 像素圆环相交的层（通常只有 1 层，跨边界时 2 层），
+// 再按精确半径确认；扇区由 angle / pitch 直接得到。层掩码表在当前半径变化后的下一次 hitTest 时重建，最多 32 层。
+//
+// 角度单位为度，0 度指向右侧、逆时针增加（与 QPainterPath::arcTo 一致）；
+// 扇区 i 从 i * pitch 度开始、跨 spanAngle 度，pitch = 360 / segmentCount（整数除法）。
+//
+// 虚拟化：segmentCount 是一层可见的扇区数（窗口大小），itemCount 是该层的条目总数。
+// 条目多于扇区时扇区 i 显示条目 firstItem + i，scroll() 移动窗口；扇区表、绘制与悬停判定都只与窗口大小有关，与条目总数无关。
+class RadialLayout {
+public:
+    struct Layer {
+        double          radius        = 0.0;     // 完全展开时的外半径
+        double          spacing       = 0.0;     // 与下一层之间的间距
+        int             segmentCount  = 1;
+        int             gapAngle      = 0;
+
+        double          currentRadius = 0.0;     // 动画中的外半径，通过 setCurrentRadius 修改
+        double          drawProgress  = 0.0;     // 扇区可见的比例 [0, 1]
+        double          opacity       = 1.0;
+
+        int             itemCount     = 0;       // 条目总数，超过 segmentCount 时分页
+        int             firstItem     = 0;       // 窗口中第一个扇区对应的条目
+
+        int             pitch         = 360;     // 以下由配置派生
+        int             spanAngle     = 360;
+        std::uint32_t   firstSegment  = 0;       // 在扇区表中的起始下标
+
+        [[nodiscard]] int visibleSpan() const { return static_cast<int>(spanAngle * drawProgress); }
+        [[nodiscard]] int lastFirstItem() const { return std::max(itemCount - segmentCount, 0); }
+        [[nodiscard]] bool paged()        const { return itemCount > segmentCount; }
+    };
+
+    struct Segment {
+        int     startAngle = 0;
+        float   labelCos   = 1.0f;   // 完全展开时扇区中线方向，标签锚点 = 中心 + 标签半径 × (cos, -sin)
+        float   labelSin   = 0.0f;
+    };
+
+    struct Hit {
+        int layer = -1;
+        int index = -1;
+    };
+
+    void addLayer(double radius, double spacing, int segmentCount, int gapAngle) {
+        Layer& layer = m_layers.emplace_back();
+        layer.radius        = radius;
+        layer.spacing       = spacing;
+        layer.segmentCount  = segmentCount;
+        layer.gapAngle      = gapAngle;
+        layer.currentRadius = radius;
+        rebuildSegments();
+        m_lookupDirty = true;
+    }
+
+    void setSegments(std::size_t layer, int segmentCount, int gapAngle) {
+        m_layers[layer].segmentCount = segmentCount;
+        m_layers[layer].gapAngle = gapAngle;
+        rebuildSegments();
+        setItemCount(layer, m_layers[layer].itemCount);
+    }
+
+    // 条目数变化后窗口夹回有效范围
+    void setItemCount(std::size_t layer, int itemCount) {
+        Layer& l = m_layers[layer];
+        l.itemCount = std::max(itemCount, 0);
+        l.firstItem = std::clamp(l.firstItem, 0, l.lastFirstItem());
+    }
+
+    // 窗口移动 delta 个条目，返回窗口是否变化
+    bool scroll(std::size_t layer, int delta) {
+        Layer& l = m_layers[layer];
+        const int first = std::clamp(l.firstItem + delta, 0, l.lastFirstItem());
+        if (first == l.firstItem) return false;
+        l.firstItem = first;
+        return true;
+    }
+
+    // 移动最少的距离使 item 落在窗口内
+    void reveal(std::size_t layer, int item) {
+        Layer& l = m_layers[layer];
+        if (item < 0) return;
+        if (item < l.firstItem) {
+            l.firstItem = item;
+        } else if (item >= l.firstItem + l.segmentCount) {
+            l.firstItem = item - l.segmentCount + 1;
+        }
+        l.firstItem = std::clamp(l.firstItem, 0, l.lastFirstItem());
+    }
+
+    // 扇区 index 当前显示的条目，index < 0 时返回 -1
+    [[nodiscard]] int itemAt(std::size_t layer, int index) const {
+        return index < 0 ? -1 : m_layers[layer].firstItem + index;
+    }
+
+    void setCurrentRadius(std::size_t layer, double radius) {
+        if (m_layers[layer].currentRadius == radius) return;
+        m_layers[layer].currentRadius = radius;
+        m_lookupDirty = true;
+    }
+
+    [[nodiscard]] auto size()   const -> std::size_t               { return m_layers.size(); }
+    [[nodiscard]] auto layers() const -> std::span<const Layer>    { return m_layers; }
+
+    [[nodiscard]] Layer&       operator[](std::size_t layer)       { return m_layers[layer]; }
+    [[nodiscard]] const Layer& operator[](std::size_t layer) const { return m_layers[layer]; }
+
+    [[nodiscard]] std::span<const Segment> segments(std::size_t layer) const {
+        const Layer& l = m_layers[layer];
+        return std::span<const Segment>(m_segments).subspan(l.firstSegment, static_cast<std::size_t>(l.segmentCount));
+    }
+
+    // 按当前半径计算的内半径：第 0 层从球体半径开始，其余层从上一层的当前外半径 + 间距开始
+    [[nodiscard]] double innerRadius(std::size_t layer, double ballRadius) const {
+        if (layer == 0) return ballRadius;
+        return m_layers[layer - 1].currentRadius + m_layers[layer - 1].spacing;
+    }
+
+    // 按完全展开的半径计算的内半径，展开 / 收起动画的起点与终点
+    [[nodiscard]] double restingInnerRadius(std::size_t layer, double ballRadius) const {
+        if (layer == 0) return ballRadius;
+        return m_layers[layer - 1].radius + m_layers[layer - 1].spacing;
+    }
+
+    // angle ∈ [0, 360)，落在间隔内或末尾不足一个 pitch 的空隙内时返回 -1
+    [[nodiscard]] int segmentAt(std::size_t layer, double angle) const {
+        const Layer& l = m_layers[layer];
+        if (l.pitch <= 0) return -1;   // 扇区数超过 360
+
+        const int index = static_cast<int>(angle) / l.pitch;
+        if (index >= l.segmentCount) return -1;
+        return (angle - index * l.pitch < l.spanAngle) ? index : -1;
+    }
+
+    // 距中心 distance、方向 angle 的点落在哪一层的哪个扇区；层按当前半径判定，与动画中的绘制一致
+    // 多层同时包含该点时（收起动画中）取层号最小的一层
+    [[nodiscard]] Hit hitTest(double distance, double angle, double ballRadius) const {
+        if (m_lookupDirty || ballRadius != m_lookupBallRadius) rebuildLookup(ballRadius);
+        if (distance < 0.0 || distance >= static_cast<double>(m_layerMasks.size())) return {};
+
+        for (std::uint32_t mask = m_layerMasks[static_cast<std::size_t>(distance)]; mask != 0; mask &= mask - 1) {
+            const auto i = static_cast<std::size_t>(std::countr_zero(mask));
+            if (distance >= innerRadius(i, ballRadius) && distance <= m_layers[i].currentRadius) {
+                return {static_cast<int>(i), segmentAt(i, angle)};
+            }
+        }
+        return {};
+    }
+
+    // 回到完全展开（expanded）或完全收起的静止状态
+    void resetAnimation(bool expanded) {
+        for (Layer& layer : m_layers) {
+            layer.currentRadius = layer.radius;
+            layer.drawProgress  = expanded ? 1.0 : 0.0;
+            layer.opacity       = 1.0;
+        }
+        m_lookupDirty = true;
+    }
+
+    void clearProgress() {
+        for (Layer& layer : m_layers) layer.drawProgress = 0.0;
+    }
+
+private:
+    void rebuildSegments() {
+        m_segments.clear();
+        for (Layer& layer : m_layers) {
+            layer.pitch = 360 / layer.segmentCount;
+            layer.spanAngle = layer.pitch - layer.gapAngle;
+            layer.firstSegment = static_cast<std::uint32_t>(m_segments.size());
+
+            for (int i = 0; i < layer.segmentCount; ++i) {
+                Segment& segment = m_segments.emplace_back();
+                segment.startAngle = i * layer.pitch;
+
+                const double rad = (segment.startAngle + layer.spanAngle / 2.0) * M_PI / 180.0;
+                segment.labelCos = static_cast<float>(Keruis::Math::fast_cos<Keruis::Math::Precision::Low>(rad));
+                segment.labelSin = static_cast<float>(Keruis::Math::fast_sin<Keruis::Math::Precision::Low>(rad));
+            }
+        }
+    }
+
+    // 第 r 项的第 i 位表示第 i 层的 [内半径, 当前外半径] 与 [r, r + 1) 相交
+    void rebuildLookup(double ballRadius) const {
+        double maxRadius = 0.0;
+        for (const Layer& layer : m_layers) maxRadius = std::max(maxRadius, layer.currentRadius);
+
+        m_layerMasks.assign(static_cast<std::size_t>(std::max(maxRadius, 0.0)) + 1, 0);
+        for (std::size_t i = 0; i < m_layers.size() && i < 32; ++i) {
+            const double inner = innerRadius(i, ballRadius);
+            const double outer = m_layers[i].currentRadius;
+            if (outer < inner || outer < 0.0) continue;
+
+            const auto first = static_cast<std::size_t>(std::max(inner, 0.0));
+            const auto last  = static_cast<std::size_t>(outer);
+            for (std::size_t r = first; r <= last; ++r) m_layerMasks[r] |= (std::uint32_t{1} << i);
+        }
+
+        m_lookupBallRadius = ballRadius;
+        m_lookupDirty = false;
+    }
+
+    std::vector<Layer>                  m_layers;
+    std::vector<Segment>                m_segments;
+
+    mutable std::vector<std::uint32_t>  m_layerMasks;
+    mutable double                      m_lookupBallRadius = -1.0;
+    mutable bool                        m_lookupDirty      = true;
+};
+
+#endif //RADIALLAYOUT_H
@@ -0,0 +1,151 @@
+#ifndef RINGLAYOUT_H
+#define RINGLAYOUT_H
+
+#include <span>
+#include <vector>
+#include <cstddef>
+
+#include <QPointF>
+#include <QRect>
+#include <QRectF>
+#include <QSize>
+#include <QPainterPath>
+
+#include "RadialLayout.h"
+#include "../../../ext/math/math.h"
+
+// 径向菜单每层扇区的几何缓存：每个扇区的环形路径和标签中心点，角度与标签方向取自 RadialLayout 的扇区表。
+// 只有某层的输入（中心、内外半径、扇区数、间隔、可见角度）变化时才重建该层，
+// 悬停 / 选中只改变颜色，不会触发重建；展开或收起动画中只有正在变化半径的层会重建。
+// 每层另外保留一份完全展开时的几何（prepare() 预先构建，或 update() 构建过一次后保留），
+// 展开动画结束时直接复制，不再重建。
+class RingLayout {
+public:
+    struct Segment {
+        QPainterPath path;
+        QPointF      label;
+        QRect        bounds;    // 扇区与标签（LabelExtent）的包围盒，用于计算重绘区域
+    };
+
+    struct Layer {
+        QPointF              center;
+        double               innerRadius  = -1.0;
+        double               outerRadius  = -1.0;
+        int                  segmentCount = 0;
+        int                  gapAngle     = 0;
+        int                  visibleSpan  = 0;
+        std::vector<Segment> segments;   // visibleSpan <= 0 时为空
+        QRect                bounds;     // 所有扇区包围盒的并集
+    };
+
+    // 标签绘制区域相对标签中心的半宽 / 半高
+    static constexpr QSize LabelExtent{20, 10};
+
+    void clear() {
+        m_layers.clear();
+        m_resting.clear();
+    }
+
+    // 最近一次 update() 的结果，该层尚未构建时返回 nullptr
+    [[nodiscard]] const Layer* find(std::size_t index) const {
+        return index < m_layers.size() ? &m_layers[index] : nullptr;
+    }
+
+    // 扇区从扇区表的起始角开始，逆时针跨 visibleSpan 度；外半径取 spec 的当前半径
+    const Layer& update(std::size_t index, const QPointF& center, double innerRadius,
+                        const RadialLayout::Layer& spec, std::span<const RadialLayout::Segment> table) {
+        if (index >= m_layers.size()) m_layers.resize(index + 1);
+
+        Layer& layer = m_layers[index];
+        if (matches(layer, center, innerRadius, spec)) return layer;
+
+        if (index < m_resting.size() && matches(m_resting[index], center, innerRadius, spec)) {
+            layer = m_resting[index];
+            return layer;
+        }
+
+        build(layer, center, innerRadius, spec, table);
+        if (spec.visibleSpan() == spec.spanAngle && spec.currentRadius == spec.radius) {
+            if (index >= m_resting.size()) m_resting.resize(index + 1);
+            m_resting[index] = layer;
+        }
+        return layer;
+    }
+
+    // 预先构建 spec 完全展开（外半径为 spec.radius、扇区完整可见）时的几何；innerRadius 为完全展开时的内半径
+    void prepare(std::size_t index, const QPointF& center, double innerRadius,
+                 const RadialLayout::Layer& spec, std::span<const RadialLayout::Segment> table) {
+        RadialLayout::Layer resting = spec;
+        resting.currentRadius = spec.radius;
+        resting.drawProgress  = 1.0;
+
+        if (index >= m_resting.size()) m_resting.resize(index + 1);
+        if (matches(m_resting[index], center, innerRadius, resting)) return;
+        build(m_resting[index], center, innerRadius, resting, table);
+    }
+
+    // 累计重建次数，供基准 / 调试观察缓存是否生效
+    [[nodiscard]] auto rebuilds() const -> std::size_t { return m_rebuilds; }
+
+private:
+    static bool matches(const Layer& layer, const QPointF& center, double innerRadius, const RadialLayout::Layer& spec) {
+        return layer.center == center && layer.innerRadius == innerRadius && layer.outerRadius == spec.currentRadius &&
+               layer.segmentCount == spec.segmentCount && layer.gapAngle == spec.gapAngle && layer.visibleSpan == spec.visibleSpan();
+    }
+
+    void build(Layer& layer, const QPointF& center, double innerRadius,
+               const RadialLayout::Layer& spec, std::span<const RadialLayout::Segment> table) {
+        const double outerRadius = spec.currentRadius;
+        const int segmentCount = spec.segmentCount;
+        const int gapAngle = spec.gapAngle;
+        const int visibleSpan = spec.visibleSpan();
+
+        layer.center       = center;
+        layer.innerRadius  = innerRadius;
+        layer.outerRadius  = outerRadius;
+        layer.segmentCount = segmentCount;
+        layer.gapAngle     = gapAngle;
+        layer.visibleSpan  = visibleSpan;
+        layer.segments.clear();
+        layer.bounds = QRect();
+        ++m_rebuilds;
+
+        if (visibleSpan <= 0 || segmentCount <= 0) return;
+
+        const QRectF innerRect(center.x() - innerRadius, center.y() - innerRadius, innerRadius * 2, innerRadius * 2);
+        const QRectF outerRect(center.x() - outerRadius, center.y() - outerRadius, outerRadius * 2, outerRadius * 2);
+        const double labelRadius = (outerRadius + innerRadius) / 2.0;
+
+        layer.segments.reserve(segmentCount);
+        for (int i = 0; i < segmentCount; ++i) {
+            const int angle = table[i].startAngle;
+
+            Segment& segment = layer.segments.emplace_back();
+            segment.path.arcMoveTo(outerRect, angle);
+            segment.path.arcTo(outerRect, angle, visibleSpan);
+            segment.path.arcTo(innerRect, angle + visibleSpan, -visibleSpan);
+            segment.path.closeSubpath();
+
+            // 完全展开时直接使用扇区表中的方向，只有展开动画中的部分扇区需要计算
+            double labelCos = table[i].labelCos;
+            double labelSin = table[i].labelSin;
+            if (visibleSpan != spec.spanAngle) {
+                const double rad = (angle + visibleSpan / 2.0) * M_PI / 180.0;
+                labelCos = Keruis::Math::fast_cos<Keruis::Math::Precision::Low>(rad);
+                labelSin = Keruis::Math::fast_sin<Keruis::Math::Precision::Low>(rad);
+            }
+            segment.label = QPointF(center.x() + labelRadius * labelCos, center.y() - labelRadius * labelSin);
+
+            const QRectF labelRect(segment.label.x() - LabelExtent.width(), segment.label.y() - LabelExtent.height(),
+                                   LabelExtent.width() * 2, LabelExtent.height() * 2);
+            segment.bounds = segment.path.boundingRect().united(labelRect).toAlignedRect().adjusted(-1, -1, 1, 1);
+            layer.bounds |= segment.bounds;
+        }
+    }
+
+    std::vector<Layer>  m_layers;
+    std::vector<Layer>  m_resting;    // 每层完全展开时的几何
+    std::size_t         m_rebuilds = 0;
+};
+
+#endif //RINGLAYOUT_H
@@ -0,0 +1,129 @@
+#ifndef SPRITECACHE_H
+#define SPRITECACHE_H
+
+#include <list>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+#include <QSize>
+#include <QImage>
+#include <QPainter>
+
+#include "../../container/RingBuffer.h"
+
+// 预渲染精灵的 LRU 缓存：key 由调用方把决定外观的量化参数打包成 64 位，
+// 精灵按设备像素比生成（物理尺寸 = 逻辑尺寸 × dpr），绘制时按逻辑尺寸贴图。
+// 总字节数超过上限时淘汰最久未使用的精灵。精灵为 QImage（ARGB32 预乘），可以在非 GUI 线程生成和绘制，
+// 但同一个 SpriteCache 只能由一个线程使用。
+//
+// 动画中的中间状态往往只出现一次，为其生成精灵比直接绘制更慢，所以未命中的 key
+// 先记入一个小的“见过”队列，第二次请求时才生成并缓存；第一次 get 返回 nullptr，由调用方直接绘制。
+class SpriteCache {
+public:
+    static constexpr std::size_t DefaultByteLimit = 4 * 1024 * 1024;
+    static constexpr std::size_t DoorkeeperSize   = 64;
+
+    struct Stats {
+        std::size_t hits      = 0;
+        std::size_t misses    = 0;   // 包括只记入“见过”队列、未生成精灵的请求
+        std::size_t evictions = 0;
+        std::size_t bytes     = 0;
+        std::size_t entries   = 0;
+    };
+
+    explicit SpriteCache(std::size_t byteLimit = DefaultByteLimit) : m_byteLimit(byteLimit), m_seen(DoorkeeperSize) {}
+
+    [[nodiscard]] auto byteLimit() const -> std::size_t { return m_byteLimit; }
+    void setByteLimit(std::size_t byteLimit) {
+        m_byteLimit = byteLimit;
+        evict();
+    }
+
+    [[nodiscard]] Stats stats() const {
+        Stats result = m_stats;
+        result.bytes = m_bytes;
+        result.entries = m_entries.size();
+        return result;
+    }
+
+    void resetStats() { m_stats = Stats{}; }
+
+    void clear() {
+        m_entries.clear();
+        m_lru.clear();
+        m_seen.clear();
+        m_bytes = 0;
+    }
+
+    // paint(QPainter&) 在逻辑坐标 [0, logicalSize) 内绘制精灵内容，背景透明
+    template <typename Paint_>
+    const QImage* get(std::uint64_t key, const QSize& logicalSize, qreal dpr, Paint_&& paint) {
+        if (const auto it = m_entries.find(key); it != m_entries.end()) {
+            ++m_stats.hits;
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            return &it->second.image;
+        }
+
+        ++m_stats.misses;
+        if (std::ranges::find(m_seen, key) == m_seen.end()) {
+            m_seen.push(key);
+            return nullptr;
+        }
+
+        QImage image(QSize(static_cast<int>(std::ceil(logicalSize.width() * dpr)),
+                           static_cast<int>(std::ceil(logicalSize.height() * dpr))),
+                     QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(dpr);
+        image.fill(Qt::transparent);
+        {
+            QPainter painter(&image);
+            painter.setRenderHint(QPainter::Antialiasing);
+            paint(painter);
+        }
+
+        const std::size_t bytes = static_cast<std::size_t>(image.sizeInBytes());
+        m_lru.push_front(key);
+        auto& entry = m_entries[key];
+        entry.image = std::move(image);
+        entry.bytes = bytes;
+        entry.lru = m_lru.begin();
+        m_bytes += bytes;
+
+        evict(key);
+        return &entry.image;
+    }
+
+private:
+    struct Entry {
+        QImage                              image;
+        std::size_t                         bytes = 0;
+        std::list<std::uint64_t>::iterator  lru;
+    };
+
+    // 淘汰到上限以内，keep 为刚生成、本次要返回的精灵，不会被淘汰
+    void evict(std::uint64_t keep = 0) {
+        while (m_bytes > m_byteLimit && !m_lru.empty()) {
+            const std::uint64_t victim = m_lru.back();
+            if (victim == keep && m_lru.size() == 1) break;
+
+            const auto it = m_entries.find(victim);
+            m_bytes -= it->second.bytes;
+            m_entries.erase(it);
+            m_lru.pop_back();
+            ++m_stats.evictions;
+        }
+    }
+
+    std::size_t                                  m_byteLimit;
+    std::size_t                                  m_bytes = 0;
+    std::unordered_map<std::uint64_t, Entry>     m_entries;
+    std::list<std::uint64_t>                     m_lru;
+    RingBuffer<std::uint64_t>                    m_seen;
+    Stats                                        m_stats;
+};
+
+#endif //SPRITECACHE_H
@@ -0,0 +1,108 @@
+#ifndef LABELCACHE_H
+#define LABELCACHE_H
+
+#include <list>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+
+#include <QFont>
+#include <QPointF>
+#include <QPainter>
+#include <QStaticText>
+
+// 菜单标签的排版缓存：每个不同的标签只用给定字体排版一次（QStaticText），之后每帧只按画笔颜色 / 透明度绘制。
+// 标签以调用方给出的整数 key（例如 StringPool::Id）标识，文本只在第一次遇到该 key 时读取并转换为 QString，
+// 所以只有实际绘制过的标签被排版，每帧的绘制不复制任何字符串。标签来源整体更换时调用 clear()。
+// 条目数超过上限时淘汰最久未使用的标签（与 SpriteCache 相同的 LRU），在同一棵大菜单里反复浏览时内存不会无限增长；
+// 上限应不小于一帧内绘制的标签数，at() 返回的引用只保证在下一次 at() 之前有效。
+class LabelCache {
+public:
+    using Key = std::uint32_t;
+
+    static constexpr std::size_t DefaultLimit = 1024;
+
+    explicit LabelCache(const QFont& font, std::size_t limit = DefaultLimit)
+        : m_font(font), m_fallback(shape(QStringLiteral("?"))), m_limit(std::max<std::size_t>(limit, 1)) {}
+
+    [[nodiscard]] auto font() const -> const QFont& { return m_font; }
+
+    void setFont(const QFont& font) {
+        m_font = font;
+        m_fallback = shape(QStringLiteral("?"));
+        clear();
+    }
+
+    [[nodiscard]] auto limit() const -> std::size_t { return m_limit; }
+    void setLimit(std::size_t limit) {
+        m_limit = std::max<std::size_t>(limit, 1);
+        evict();
+    }
+
+    void clear() {
+        m_texts.clear();
+        m_lru.clear();
+    }
+
+    [[nodiscard]] const QStaticText& at(Key key, std::string_view label) const {
+        if (const auto it = m_texts.find(key); it != m_texts.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+            return it->second.text;
+        }
+
+        m_lru.push_front(key);
+        Entry& entry = m_texts[key];
+        entry.text = shape(QString::fromUtf8(label.data(), static_cast<qsizetype>(label.size())));
+        entry.lru = m_lru.begin();
+
+        evict();
+        return entry.text;
+    }
+
+    // 没有对应条目时显示的 "?"
+    [[nodiscard]] auto fallback() const -> const QStaticText& { return m_fallback; }
+
+    // 以 center 为中心绘制，颜色取 painter 当前画笔
+    void paint(QPainter& painter, const QStaticText& text, const QPointF& center) const {
+        const QSizeF size = text.size();
+        painter.setFont(m_font);
+        painter.drawStaticText(QPointF(center.x() - size.width() / 2.0, center.y() - size.height() / 2.0), text);
+    }
+
+    [[nodiscard]] auto size()      const -> std::size_t { return m_texts.size(); }   // 已排版的标签数
+    [[nodiscard]] auto evictions() const -> std::size_t { return m_evictions;    }   // 累计淘汰的标签数
+
+private:
+    struct Entry {
+        QStaticText              text;
+        std::list<Key>::iterator lru;
+    };
+
+    // 淘汰到上限以内；刚加入的标签在队首，上限至少为 1，所以不会被淘汰
+    void evict() const {
+        while (m_texts.size() > m_limit) {
+            m_texts.erase(m_lru.back());
+            m_lru.pop_back();
+            ++m_evictions;
+        }
+    }
+
+    [[nodiscard]] QStaticText shape(const QString& label) const {
+        QStaticText text(label);
+        text.setTextFormat(Qt::PlainText);
+        text.setPerformanceHint(QStaticText::AggressiveCaching);
+        text.prepare(QTransform(), m_font);
+        return text;
+    }
+
+    QFont                                           m_font;
+    QStaticText                                     m_fallback;
+    std::size_t                                     m_limit;
+    mutable std::unordered_map<Key, Entry>          m_texts;
+    mutable std::list<Key>                          m_lru;
+    mutable std::size_t                             m_evictions = 0;
+};
+
+#endif //LABELCACHE_H
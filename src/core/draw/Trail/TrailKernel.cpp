@@ -0,0 +1,342 @@
+#include "TrailKernel.h"
+#include "../../../ext/math/approx.h"
+
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define KERUIS_TRAIL_X86 1
+    #include <immintrin.h>
+#else
+    #define KERUIS_TRAIL_X86 0
+#endif
+
+namespace Keruis::Trail {
+
+    namespace {
+
+        // 与 Keruis::Math::fast_atan2<Precision::High> 使用同一组系数
+        using Keruis::Math::Coeff::AtanHigh;
+
+        constexpr float AtanA2  = static_cast<float>(AtanHigh[1]);
+        constexpr float AtanA4  = static_cast<float>(AtanHigh[2]);
+        constexpr float AtanA6  = static_cast<float>(AtanHigh[3]);
+        constexpr float AtanA8  = static_cast<float>(AtanHigh[4]);
+        constexpr float AtanA10 = static_cast<float>(AtanHigh[5]);
+        constexpr float AtanA12 = static_cast<float>(AtanHigh[6]);
+        constexpr float AtanA14 = static_cast<float>(AtanHigh[7]);
+        constexpr float AtanA16 = static_cast<float>(AtanHigh[8]);
+
+        constexpr float Pi     = static_cast<float>(Keruis::Math::Coeff::Pi);
+        constexpr float HalfPi = static_cast<float>(Keruis::Math::Coeff::HalfPi);
+
+        // ======= 标量 =======
+
+        inline float curveScalar(float len) {
+            return (len < 0.0f) ? 0.0f : ((len > 0.5f) ? 1.0f : len / 0.5f);
+        }
+
+        inline void directionScalar(const SegmentInput& in, const SegmentOutput& out, std::size_t k) {
+            const SegmentDirection d = direction(in.x[k + 1] - in.x[k], in.y[k + 1] - in.y[k]);
+            out.length[k] = d.length;
+            out.angle[k]  = d.angle;
+            out.dirX[k]   = d.dirX;
+            out.dirY[k]   = d.dirY;
+        }
+
+        inline void offsetScalar(const SegmentInput& in, const SegmentDirections& dirs, const SegmentOffsets& out,
+                                 std::size_t k, float prevDirX, float prevDirY) {
+            const float scl = curveScalar(dirs.length[k]) * in.radius * in.scale[k] / in.capSize;
+            const float prevProg = in.firstProgress + static_cast<float>(k);
+            const float nextProg = prevProg + 1.0f;
+
+            out.startX[k] = prevDirX * (scl * prevProg);
+            out.startY[k] = prevDirY * (scl * prevProg);
+            out.endX[k]   = dirs.dirX[k] * (scl * nextProg);
+            out.endY[k]   = dirs.dirY[k] * (scl * nextProg);
+        }
+
+        void directionsScalar(const SegmentInput& in, const SegmentOutput& out, std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) directionScalar(in, out, k);
+        }
+
+        void offsetsScalar(const SegmentInput& in, const SegmentDirections& dirs, const SegmentOffsets& out,
+                           std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) {
+                if (k == 0) {
+                    offsetScalar(in, dirs, out, 0, std::sin(in.startAngle), std::cos(in.startAngle));
+                } else {
+                    offsetScalar(in, dirs, out, k, dirs.dirX[k - 1], dirs.dirY[k - 1]);
+                }
+            }
+        }
+
+#if KERUIS_TRAIL_X86
+
+        // ======= SSE2 =======
+
+        __attribute__((target("sse2")))
+        inline __m128 selectSse(__m128 mask, __m128 a, __m128 b) {
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+
+        __attribute__((target("sse2")))
+        inline __m128 atan2Sse(__m128 y, __m128 x) {
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            const __m128 one      = _mm_set1_ps(1.0f);
+
+            const __m128 ax = _mm_andnot_ps(signMask, x);
+            const __m128 ay = _mm_andnot_ps(signMask, y);
+            const __m128 mn = _mm_min_ps(ax, ay);
+            __m128       mx = _mm_max_ps(ax, ay);
+            mx = selectSse(_mm_cmpeq_ps(mx, _mm_setzero_ps()), one, mx);
+
+            const __m128 t  = _mm_div_ps(mn, mx);
+            const __m128 t2 = _mm_mul_ps(t, t);
+
+            __m128 p = _mm_set1_ps(AtanA16);
+            p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(AtanA14));
+            p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(AtanA12));
+            p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(AtanA10));
+            p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(AtanA8));
+            p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(AtanA6));
+            p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(AtanA4));
+            p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(AtanA2));
+            p = _mm_add_ps(_mm_mul_ps(p, t2), one);
+            __m128 r = _mm_mul_ps(p, t);
+
+            r = selectSse(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(HalfPi), r), r);
+
+            const __m128 xNegative = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x), 31));
+            r = selectSse(xNegative, _mm_sub_ps(_mm_set1_ps(Pi), r), r);
+
+            return _mm_or_ps(r, _mm_and_ps(y, signMask));
+        }
+
+        __attribute__((target("sse2")))
+        void directionsSse2(const SegmentInput& in, const SegmentOutput& out, std::size_t end) {
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            const __m128 zero     = _mm_setzero_ps();
+            const __m128 one      = _mm_set1_ps(1.0f);
+
+            std::size_t k = 0;
+            for (; k + 4 <= end; k += 4) {
+                const __m128 dx = _mm_sub_ps(_mm_loadu_ps(in.x + k + 1), _mm_loadu_ps(in.x + k));
+                const __m128 dy = _mm_sub_ps(_mm_loadu_ps(in.y + k + 1), _mm_loadu_ps(in.y + k));
+                const __m128 nx = _mm_xor_ps(dx, signMask);
+                const __m128 ny = _mm_xor_ps(dy, signMask);
+
+                const __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+                const __m128 degenerate = _mm_cmpeq_ps(len, zero);
+                const __m128 safeLen = selectSse(degenerate, one, len);
+
+                _mm_storeu_ps(out.length + k, len);
+                _mm_storeu_ps(out.angle + k, atan2Sse(ny, nx));
+                _mm_storeu_ps(out.dirX + k, _mm_andnot_ps(degenerate, _mm_div_ps(ny, safeLen)));
+                // 零长度线段与标量一致：cos(atan2(-dy, -dx))，-dx 为 +0 时是 1，为 -0 时是 -1
+                const __m128 fallbackY = _mm_or_ps(one, _mm_and_ps(nx, signMask));
+                _mm_storeu_ps(out.dirY + k, selectSse(degenerate, fallbackY, _mm_div_ps(nx, safeLen)));
+            }
+
+            directionsScalar(in, out, k, end);
+        }
+
+        __attribute__((target("sse2")))
+        void offsetsSse2(const SegmentInput& in, const SegmentDirections& dirs, const SegmentOffsets& out, std::size_t end) {
+            offsetsScalar(in, dirs, out, 0, std::min<std::size_t>(end, 1));
+
+            const __m128 half   = _mm_set1_ps(0.5f);
+            const __m128 one    = _mm_set1_ps(1.0f);
+            const __m128 radius = _mm_set1_ps(in.radius);
+            const __m128 cap    = _mm_set1_ps(in.capSize);
+            const __m128 lane   = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+
+            std::size_t k = 1;
+            for (; k + 4 <= end; k += 4) {
+                const __m128 len = _mm_loadu_ps(dirs.length + k);
+                const __m128 curve = _mm_min_ps(_mm_div_ps(len, half), one);
+                const __m128 scl = _mm_div_ps(_mm_mul_ps(_mm_mul_ps(curve, radius), _mm_loadu_ps(in.scale + k)), cap);
+
+                const __m128 prevProg = _mm_add_ps(_mm_set1_ps(in.firstProgress + static_cast<float>(k)), lane);
+                const __m128 startLen = _mm_mul_ps(scl, prevProg);
+                const __m128 endLen   = _mm_mul_ps(scl, _mm_add_ps(prevProg, one));
+
+                _mm_storeu_ps(out.startX + k, _mm_mul_ps(_mm_loadu_ps(dirs.dirX + k - 1), startLen));
+                _mm_storeu_ps(out.startY + k, _mm_mul_ps(_mm_loadu_ps(dirs.dirY + k - 1), startLen));
+                _mm_storeu_ps(out.endX + k, _mm_mul_ps(_mm_loadu_ps(dirs.dirX + k), endLen));
+                _mm_storeu_ps(out.endY + k, _mm_mul_ps(_mm_loadu_ps(dirs.dirY + k), endLen));
+            }
+
+            offsetsScalar(in, dirs, out, k, end);
+        }
+
+        // ======= AVX2 =======
+
+        __attribute__((target("avx2")))
+        inline __m256 atan2Avx(__m256 y, __m256 x) {
+            const __m256 signMask = _mm256_set1_ps(-0.0f);
+            const __m256 one      = _mm256_set1_ps(1.0f);
+
+            const __m256 ax = _mm256_andnot_ps(signMask, x);
+            const __m256 ay = _mm256_andnot_ps(signMask, y);
+            const __m256 mn = _mm256_min_ps(ax, ay);
+            __m256       mx = _mm256_max_ps(ax, ay);
+            mx = _mm256_blendv_ps(mx, one, _mm256_cmp_ps(mx, _mm256_setzero_ps(), _CMP_EQ_OQ));
+
+            const __m256 t  = _mm256_div_ps(mn, mx);
+            const __m256 t2 = _mm256_mul_ps(t, t);
+
+            __m256 p = _mm256_set1_ps(AtanA16);
+            p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(AtanA14));
+            p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(AtanA12));
+            p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(AtanA10));
+            p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(AtanA8));
+            p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(AtanA6));
+            p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(AtanA4));
+            p = _mm256_add_ps(_mm256_mul_ps(p, t2), _mm256_set1_ps(AtanA2));
+            p = _mm256_add_ps(_mm256_mul_ps(p, t2), one);
+            __m256 r = _mm256_mul_ps(p, t);
+
+            r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(HalfPi), r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+            r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(Pi), r), x);
+
+            return _mm256_or_ps(r, _mm256_and_ps(y, signMask));
+        }
+
+        __attribute__((target("avx2")))
+        void directionsAvx2(const SegmentInput& in, const SegmentOutput& out, std::size_t end) {
+            const __m256 signMask = _mm256_set1_ps(-0.0f);
+            const __m256 zero     = _mm256_setzero_ps();
+            const __m256 one      = _mm256_set1_ps(1.0f);
+
+            std::size_t k = 0;
+            for (; k + 8 <= end; k += 8) {
+                const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(in.x + k + 1), _mm256_loadu_ps(in.x + k));
+                const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(in.y + k + 1), _mm256_loadu_ps(in.y + k));
+                const __m256 nx = _mm256_xor_ps(dx, signMask);
+                const __m256 ny = _mm256_xor_ps(dy, signMask);
+
+                const __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+                const __m256 degenerate = _mm256_cmp_ps(len, zero, _CMP_EQ_OQ);
+                const __m256 safeLen = _mm256_blendv_ps(len, one, degenerate);
+
+                _mm256_storeu_ps(out.length + k, len);
+                _mm256_storeu_ps(out.angle + k, atan2Avx(ny, nx));
+                _mm256_storeu_ps(out.dirX + k, _mm256_andnot_ps(degenerate, _mm256_div_ps(ny, safeLen)));
+                const __m256 fallbackY = _mm256_or_ps(one, _mm256_and_ps(nx, signMask));
+                _mm256_storeu_ps(out.dirY + k, _mm256_blendv_ps(_mm256_div_ps(nx, safeLen), fallbackY, degenerate));
+            }
+
+            directionsScalar(in, out, k, end);
+        }
+
+        __attribute__((target("avx2")))
+        void offsetsAvx2(const SegmentInput& in, const SegmentDirections& dirs, const SegmentOffsets& out, std::size_t end) {
+            offsetsScalar(in, dirs, out, 0, std::min<std::size_t>(end, 1));
+
+            const __m256 half   = _mm256_set1_ps(0.5f);
+            const __m256 one    = _mm256_set1_ps(1.0f);
+            const __m256 radius = _mm256_set1_ps(in.radius);
+            const __m256 cap    = _mm256_set1_ps(in.capSize);
+            const __m256 lane   = _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f);
+
+            std::size_t k = 1;
+            for (; k + 8 <= end; k += 8) {
+                const __m256 len = _mm256_loadu_ps(dirs.length + k);
+                const __m256 curve = _mm256_min_ps(_mm256_div_ps(len, half), one);
+                const __m256 scl = _mm256_div_ps(_mm256_mul_ps(_mm256_mul_ps(curve, radius), _mm256_loadu_ps(in.scale + k)), cap);
+
+                const __m256 prevProg = _mm256_add_ps(_mm256_set1_ps(in.firstProgress + static_cast<float>(k)), lane);
+                const __m256 startLen = _mm256_mul_ps(scl, prevProg);
+                const __m256 endLen   = _mm256_mul_ps(scl, _mm256_add_ps(prevProg, one));
+
+                _mm256_storeu_ps(out.startX + k, _mm256_mul_ps(_mm256_loadu_ps(dirs.dirX + k - 1), startLen));
+                _mm256_storeu_ps(out.startY + k, _mm256_mul_ps(_mm256_loadu_ps(dirs.dirY + k - 1), startLen));
+                _mm256_storeu_ps(out.endX + k, _mm256_mul_ps(_mm256_loadu_ps(dirs.dirX + k), endLen));
+                _mm256_storeu_ps(out.endY + k, _mm256_mul_ps(_mm256_loadu_ps(dirs.dirY + k), endLen));
+            }
+
+            offsetsScalar(in, dirs, out, k, end);
+        }
+
+#endif
+
+        KernelIsa supportedIsa() {
+            static const KernelIsa isa = detectIsa();
+            return isa;
+        }
+
+        std::atomic<KernelIsa>& isaSlot() {
+            static std::atomic<KernelIsa> isa{supportedIsa()};
+            return isa;
+        }
+
+    }
+
+    KernelIsa detectIsa() {
+#if KERUIS_TRAIL_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return KernelIsa::AVX2;
+        if (__builtin_cpu_supports("sse2")) return KernelIsa::SSE2;
+#endif
+        return KernelIsa::Scalar;
+    }
+
+    KernelIsa activeIsa() {
+        return isaSlot().load(std::memory_order_relaxed);
+    }
+
+    void setIsa(KernelIsa isa) {
+        isaSlot().store(std::min(isa, supportedIsa()), std::memory_order_relaxed);
+    }
+
+    void computeSegments(const SegmentInput& in, const SegmentOutput& out) {
+        computeSegments(in, out, activeIsa());
+    }
+
+    void computeSegments(const SegmentInput& in, const SegmentOutput& out, KernelIsa isa) {
+        if (in.count < 2) return;
+        const std::size_t segments = in.count - 1;
+
+        switch (std::min(isa, supportedIsa())) {
+#if KERUIS_TRAIL_X86
+            case KernelIsa::AVX2:
+                directionsAvx2(in, out, segments);
+                break;
+            case KernelIsa::SSE2:
+                directionsSse2(in, out, segments);
+                break;
+#endif
+            default:
+                directionsScalar(in, out, 0, segments);
+                break;
+        }
+
+        computeOffsets(in, {out.length, out.dirX, out.dirY}, {out.startX, out.startY, out.endX, out.endY}, isa);
+    }
+
+    void computeOffsets(const SegmentInput& in, const SegmentDirections& dirs, const SegmentOffsets& out) {
+        computeOffsets(in, dirs, out, activeIsa());
+    }
+
+    void computeOffsets(const SegmentInput& in, const SegmentDirections& dirs, const SegmentOffsets& out, KernelIsa isa) {
+        if (in.count < 2) return;
+        const std::size_t segments = in.count - 1;
+
+        switch (std::min(isa, supportedIsa())) {
+#if KERUIS_TRAIL_X86
+            case KernelIsa::AVX2:
+                offsetsAvx2(in, dirs, out, segments);
+                return;
+            case KernelIsa::SSE2:
+                offsetsSse2(in, dirs, out, segments);
+                return;
+#endif
+            default:
+                offsetsScalar(in, dirs, out, 0, segments);
+                return;
+        }
+    }
+
+}
@@ -0,0 +1,97 @@
+#ifndef TRAILKERNEL_H
+#define TRAILKERNEL_H
+
+#include <cmath>
+#include <cstddef>
+
+namespace Keruis::Trail {
+
+    // 批量计算的输入：count 个节点（SoA），产生 count - 1 个线段
+    struct SegmentInput {
+        const float* x;
+        const float* y;
+        const float* scale;
+        std::size_t  count;
+
+        float        radius;
+        float        capSize;
+        float        firstProgress;   // 第 0 段起点的进度，之后每段 +1
+        float        startAngle;      // 第 0 段起点边使用的角度（上一段的方向）
+    };
+
+    // 每个数组至少 count - 1 个元素。第 k 段连接节点 k 与 k + 1：
+    //   angle = atan2(-dy, -dx)，dir = (sin(angle), cos(angle))
+    //   start = 起点边的半宽偏移（使用上一段的方向），end = 终点边的半宽偏移
+    // 与 TrailPath::each 的标量实现一致：四个角点为 prev ∓ start、next ± end
+    struct SegmentOutput {
+        float* length;
+        float* angle;
+        float* dirX;
+        float* dirY;
+        float* startX;
+        float* startY;
+        float* endX;
+        float* endY;
+    };
+
+    // computeOffsets 的输入：逐段的长度与方向，通常来自 computeSegments 或 TrailPath 的几何缓存
+    struct SegmentDirections {
+        const float* length;
+        const float* dirX;
+        const float* dirY;
+    };
+
+    struct SegmentOffsets {
+        float* startX;
+        float* startY;
+        float* endX;
+        float* endY;
+    };
+
+    // 单个线段的长度 / 角度 / 方向，与 computeSegments 的标量实现一致
+    struct SegmentDirection {
+        float length;
+        float angle;
+        float dirX;
+        float dirY;
+    };
+
+    [[nodiscard]] inline SegmentDirection direction(const float dx, const float dy) {
+        const float len = std::sqrt(dx * dx + dy * dy);
+        const float angle = std::atan2(-dy, -dx);
+        if (len > 0.0f) {
+            return {len, angle, -dy / len, -dx / len};
+        }
+        return {len, angle, std::sin(angle), std::cos(angle)};
+    }
+
+    enum class KernelIsa {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    // 与标量实现（std::sqrt / std::atan2 / std::cos / std::sin）的最大偏差：
+    //   角度 <= AngleTolerance 弧度；偏移量 <= OffsetTolerance * max(1, |偏移|) 像素
+    inline constexpr float AngleTolerance  = 2e-6f;
+    inline constexpr float OffsetTolerance = 1e-5f;
+
+    // 运行时根据 CPU 选择的指令集（AVX2 > SSE2 > Scalar）
+    [[nodiscard]] KernelIsa detectIsa();
+    [[nodiscard]] KernelIsa activeIsa();
+
+    // 强制使用指定指令集（测试/基准用），不支持时退回到可用的最高级别
+    void setIsa(KernelIsa isa);
+
+    // 完整计算：方向 + 偏移
+    void computeSegments(const SegmentInput& in, const SegmentOutput& out);
+    void computeSegments(const SegmentInput& in, const SegmentOutput& out, KernelIsa isa);
+
+    // 只计算偏移：方向已知（已缓存）时每帧只需这一步，除第 0 段起点的一次 sin / cos 外不含超越函数。
+    // in.x / in.y 不会被读取
+    void computeOffsets(const SegmentInput& in, const SegmentDirections& dirs, const SegmentOffsets& out);
+    void computeOffsets(const SegmentInput& in, const SegmentDirections& dirs, const SegmentOffsets& out, KernelIsa isa);
+
+}
+
+#endif //TRAILKERNEL_H
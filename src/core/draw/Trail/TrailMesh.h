@@ -0,0 +1,90 @@
+#ifndef TRAILMESH_H
+#define TRAILMESH_H
+
+#include <array>
+#include <span>
+#include <vector>
+#include <algorithm>
+
+#include <QPointF>
+#include <QColor>
+#include <QPainter>
+
+#include "TrailPath.h"
+
+// 把整条 TrailPath 一次性转换为可复用的顶点缓冲（每段 4 个顶点，带逐顶点 alpha），
+// 然后批量绘制。缓冲区在帧之间复用，稳定后不再分配内存。
+//
+// 相邻四边形共用一条边，拐弯处还会相互重叠：逐个填充时重叠处的 alpha 叠加、共用边的抗锯齿互相补足，
+// 合并成一条路径填充会丢失这些叠加。所以 paint() 仍逐个填充四边形（与逐段绘制的像素相同），
+// 只省去每段的 QPolygonF 分配，并且只在 alpha 改变时切换画刷。
+class TrailMesh {
+public:
+    struct Vertex {
+        QPointF pos;
+        float   alpha;
+    };
+
+    void clear() {
+        m_vertices.clear();
+    }
+
+    // 顶点顺序与 TrailPath::each 的回调一致：p1 p2 p3 p4，p1/p2 使用前一节点的进度，p3/p4 使用后一节点的进度
+    void build(TrailPath& path, float radius, const QPointF& offset = {}, float percent = 1.0f) {
+        m_vertices.clear();
+
+        path.each(radius, [&](int,
+                              const QPointF& p1, const QPointF& p2,
+                              const QPointF& p3, const QPointF& p4,
+                              float progress1, float progress2) {
+            m_vertices.push_back({p1 - offset, progress1});
+            m_vertices.push_back({p2 - offset, progress1});
+            m_vertices.push_back({p3 - offset, progress2});
+            m_vertices.push_back({p4 - offset, progress2});
+        }, percent);
+    }
+
+    // 使用在别处（例如另一个线程的 TrailMesh）生成的顶点
+    void assign(std::span<const Vertex> vertices) {
+        m_vertices.assign(vertices.begin(), vertices.end());
+    }
+
+    // 每个四边形使用 p1 的 alpha（color.alpha() * progress1，截断为整数）
+    void paint(QPainter& painter, const QColor& color) {
+        if (m_vertices.empty()) return;
+
+        painter.save();
+        painter.setPen(Qt::NoPen);
+
+        QColor quadColor = color;
+        int brushAlpha = -1;
+        for (std::size_t i = 0; i + 3 < m_vertices.size(); i += 4) {
+            const int alpha = alphaOf(color, m_vertices[i].alpha);
+            if (alpha <= 0) continue;
+
+            if (alpha != brushAlpha) {
+                quadColor.setAlpha(alpha);
+                painter.setBrush(quadColor);
+                brushAlpha = alpha;
+            }
+
+            const std::array<QPointF, 4> quad = {m_vertices[i].pos, m_vertices[i + 1].pos,
+                                                 m_vertices[i + 2].pos, m_vertices[i + 3].pos};
+            painter.drawPolygon(quad.data(), static_cast<int>(quad.size()));
+        }
+
+        painter.restore();
+    }
+
+    [[nodiscard]] auto vertices()  const -> std::span<const Vertex> { return m_vertices;               }
+    [[nodiscard]] auto quadCount() const -> std::size_t             { return m_vertices.size() / 4;    }
+
+private:
+    [[nodiscard]] static int alphaOf(const QColor& color, float alpha) {
+        return std::clamp(static_cast<int>(static_cast<float>(color.alpha()) * alpha), 0, 255);
+    }
+
+    std::vector<Vertex>                     m_vertices;
+};
+
+#endif //TRAILMESH_H
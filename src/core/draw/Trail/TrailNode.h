@@ -5,8 +5,9 @@
 
 struct TrailNode {
     QPointF pos;
-    float scale;
+    float scale = 0.0f;
 
+    TrailNode() = default;
     TrailNode(const QPointF& pos, float scale) : pos(pos), scale(scale) {}
 
     static constexpr QPointF lerp(const QPointF& a, const QPointF& b, float t) noexcept {
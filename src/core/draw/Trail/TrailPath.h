@@ -1,108 +1,415 @@
 #ifndef TRAILPATH_H
 #define TRAILPATH_H
 
+#include <span>
+#include <chrono>
 #include <vector>
+#include <cstdint>
 #include <algorithm>
 
 #include <QPointF>
+#include <QRectF>
 #include <QPainter>
 #include <QMutex>
 
 #include "TrailNode.h"
+#include "TrailSoA.h"
+#include "TrailKernel.h"
+#include "../../container/RingBuffer.h"
+#include "../../container/SoARing.h"
 #include "../../../ext/math/math.h"
 
+// 拖尾路径。
+//
+// 每个线段的长度 / 方向在节点加入时计算一次并缓存（与节点同步的镜像环形缓冲），
+// 之后的每一帧只需按当前 radius / percent 把缓存的方向乘上宽度得到四个角点，
+// 不再有 sqrt / atan2 / sin / cos。radius 与 percent 不参与缓存内容，修改它们不会使缓存失效；
+// 新节点只计算最新的一个线段，淘汰最旧节点时对应的缓存行随之淘汰。
+// each() 仍是每帧 O(可见线段数)：锥形的宽度随 capSize 与每段的进度变化，每个可见线段的偏移量与角点
+// 每帧都要重新计算一遍（computeOffsets），缓存省去的只是其中的 sqrt / atan2 / sin / cos。
+//
+// 输入先经过重采样：节点沿输入折线按固定间距 spacing 放置，输入点本身不丢弃也不合并，只决定折线的形状；
+// 最新节点总是位于最新输入点（浮动），与上一个固定节点的距离不足 spacing 时只移动它。
+// 节点密度因此只取决于 spacing 而与鼠标回报率无关；超过 lifetime 的节点会被 expire() 淘汰。
 class TrailPath {
 public:
+    using Clock = std::chrono::steady_clock;
 
-    [[nodiscard]] auto size() -> std::size_t {return m_points.size();}
+    static constexpr std::size_t DefaultCapacity = 100;
 
-    void clear() {m_points.clear();}
+    // 默认不重采样、不过期，行为与逐点加入相同
+    struct Resampling {
+        float                       spacing  = 0.0f;                          // 固定节点沿输入折线的间距（像素），0 表示每个输入点一个节点
+        std::chrono::milliseconds   lifetime = std::chrono::milliseconds(0);  // 节点存活时间，0 表示不过期
+    };
 
-    void addPoint(const QPointF& pos, float scale = 1.0f) {
-        if (m_points.size() >= m_capacity) {
-            m_points.erase(m_points.begin());
+    // AoS：节点以 TrailNode 数组存放；SoA：节点按分量连续存放。
+    // SoA 以 float 存储坐标，坐标在 ±4096 以内时两种模式输出的角点相差不超过 1e-4 像素
+    enum class Storage {
+        AoS,
+        SoA
+    };
+
+    // 几何缓存计数：computedSegments 为实际计算（sqrt + atan2）的线段数，
+    // reusedSegments 为绘制时直接取自缓存的线段数，frames 为 each() 的调用次数
+    struct Stats {
+        std::size_t computedSegments = 0;
+        std::size_t reusedSegments   = 0;
+        std::size_t frames           = 0;
+        std::size_t mergedPoints     = 0;   // 只移动了浮动节点、没有增加节点的输入点数
+        std::size_t expiredNodes     = 0;
+    };
+
+    explicit TrailPath(std::size_t capacity = DefaultCapacity, Storage storage = Storage::AoS)
+        : m_storage(storage),
+          m_points(storage == Storage::AoS ? capacity : 1),
+          m_soa(storage == Storage::SoA ? capacity : 1),
+          m_cache(capacity),
+          m_times(capacity)
+    {
+        m_offsets.resize(m_cache.capacity());
+    }
+
+    [[nodiscard]] auto storage()  const -> Storage     {return m_storage;}
+    [[nodiscard]] auto size()     const -> std::size_t {return m_cache.size();}
+    [[nodiscard]] auto capacity() const -> std::size_t {return m_cache.capacity();}
+    [[nodiscard]] bool empty()    const                {return m_cache.empty();}
+
+    [[nodiscard]] auto stats()    const -> const Stats& {return m_stats;}
+    void resetStats() {m_stats = {};}
+
+    // 按逻辑下标读取节点，0 为最旧的节点
+    [[nodiscard]] TrailNode node(std::size_t i) const {return m_storage == Storage::SoA ? m_soa[i] : m_points[i];}
+
+    // 所有节点位置的包围盒，不含线段宽度；空路径返回空矩形
+    [[nodiscard]] QRectF bounds() const {
+        if (empty()) return {};
+
+        QPointF lo = position(0), hi = lo;
+        for (std::size_t i = 1; i < size(); ++i) {
+            const QPointF p = position(i);
+            lo = QPointF(std::min(lo.x(), p.x()), std::min(lo.y(), p.y()));
+            hi = QPointF(std::max(hi.x(), p.x()), std::max(hi.y(), p.y()));
         }
-        m_points.emplace_back(TrailNode{pos, scale});
+        return QRectF(lo, hi);
     }
 
-    template <typename Func>
-    void each(const float radius, Func consumer, float percent = 1.0f) {
-        if (m_points.empty()) return;
+    void clear() {m_points.clear(); m_soa.clear(); m_cache.clear(); m_times.clear(); m_carry = 0.0; m_floatingHead = false;}
 
-        percent = std::clamp(percent, 0.0f, 1.0f);
+    [[nodiscard]] auto resampling() const -> const Resampling& {return m_resampling;}
+    void setResampling(const Resampling& resampling) {m_resampling = resampling;}
 
-        float lastAngle = 0.0f;
-        const float capSize = static_cast<float>(this->size() - 1) * percent;
+    // 运行时修改容量（会重新分配一次），保留最新的节点；缓存行与节点一起保留，无需重算
+    void setCapacity(std::size_t capacity) {
+        if (m_storage == Storage::SoA) {
+            m_soa.setCapacity(capacity);
+        } else {
+            m_points.setCapacity(capacity);
+        }
+        m_cache.setCapacity(capacity);
+        m_times.setCapacity(capacity);
+        m_offsets.resize(m_cache.capacity());
+    }
 
-        auto drawImpl = [&](
-            std::size_t index,
-            const TrailNode& prev,
-            const TrailNode& next,
-            const float prevProg,
-            const float nextProg
-        ) -> float {
-            const QPointF dst = next.pos - prev.pos;
-            const float scl = Keruis::Math::curve(static_cast<float>(std::sqrt(dst.x() * dst.x() + dst.y() * dst.y())), 0.0f, 0.5f) * radius * prev.scale / capSize;
-            const float z2 = static_cast<float>(std::atan2(-dst.y(), -dst.x()));
+    // 切换存储方式，已有节点会被搬运到新的存储中
+    void setStorage(Storage storage) {
+        if (storage == m_storage) return;
 
-            const float z1 = lastAngle;
+        const std::size_t cap = capacity();
+        if (storage == Storage::SoA) {
+            m_soa.setCapacity(cap);
+            m_soa.clear();
+            for (const TrailNode& n : m_points) m_soa.push(n.pos, n.scale);
+            m_points.clear();
+            m_points.setCapacity(1);
+        } else {
+            m_points.setCapacity(cap);
+            m_points.clear();
+            for (std::size_t i = 0; i < m_soa.size(); ++i) m_points.push(m_soa[i]);
+            m_soa.clear();
+            m_soa.setCapacity(1);
+        }
+        m_storage = storage;
+    }
 
-            const QPointF c = Keruis::Math::from_polar_rad<QPointF>(static_cast<float>(M_PI_2 - z1), scl * prevProg);
-            const QPointF n = Keruis::Math::from_polar_rad<QPointF>(static_cast<float>(M_PI_2 - z2), scl * nextProg);
+    void addPoint(const QPointF& pos, float scale = 1.0f, Clock::time_point time = Clock::now()) {
+        const double spacing = m_resampling.spacing;
+        if (empty() || spacing <= 0.0) {
+            pushNode(pos, scale, time);
+            m_lastInput = pos;
+            m_carry = 0.0;
+            m_floatingHead = false;
+            return;
+        }
 
-            if (Keruis::Math::equals(c, {}, 0.01f) && Keruis::Math::equals(n, {}, 0.01f)) {
-                return z2;
-            }
+        // 沿上一个输入点到 pos 的线段，距上一个固定节点（沿折线）每满 spacing 放置一个固定节点
+        const QPointF from = m_lastInput;
+        const QPointF d = pos - from;
+        const double length = std::sqrt(d.x() * d.x() + d.y() * d.y());
+        if (length <= 0.0) return;
+        m_lastInput = pos;
 
-            if constexpr(std::invocable<Func, int, QPointF, QPointF, QPointF, QPointF, float, float>){
-                float progressFormer = prevProg / capSize;
-                float progressLatter = nextProg / capSize;
-
-                consumer(index, prev.pos - c, prev.pos + c, next.pos + n, next.pos - n, progressFormer, progressLatter);
-            } else if constexpr(std::invocable<Func, int, QPointF, QPointF, QPointF, QPointF>){
-                consumer(index, prev.pos - c, prev.pos + c, next.pos + n, next.pos - n);
-            } else if constexpr(std::invocable<Func, QPointF, QPointF, QPointF, QPointF, float, float>){
-                float progressFormer = prevProg / capSize;
-                float progressLatter = nextProg / capSize;
-
-                consumer(prev.pos - c, prev.pos + c, next.pos + n, next.pos - n, progressFormer, progressLatter);
-            } else if constexpr(std::invocable<Func, QPointF, QPointF, QPointF, QPointF>){
-                consumer(prev.pos - c, prev.pos + c, next.pos + n, next.pos - n);
-            } else{
-                qDebug() << "consumer not supported";
-            }
+        bool placed = false;
+        double t = spacing - m_carry;
+        for (; t <= length; t += spacing) {
+            placeNode(from + d * (t / length), scale, time);
+            m_floatingHead = false;
+            placed = true;
+        }
+        m_carry = length - (t - spacing);
 
-            return z2;
-        };
+        // 余下不足 spacing 的部分由浮动节点补到 pos，拖尾始终连到最新输入点（与固定节点几乎重合时不放置）
+        if (m_carry > 1e-3) {
+            if (!placed && m_floatingHead) ++m_stats.mergedPoints;
+            placeNode(pos, scale, time);
+            m_floatingHead = true;
+        }
+    }
+
+    // 淘汰超过 lifetime 的最旧节点，返回淘汰的数量；节点变少后剩余部分的锥形会随之收缩，形成淡出
+    std::size_t expire(Clock::time_point now = Clock::now()) {
+        if (m_resampling.lifetime.count() <= 0) return 0;
+
+        std::size_t expired = 0;
+        while (!empty() && now - m_times.front() > m_resampling.lifetime) {
+            popFront();
+            ++expired;
+        }
+        m_stats.expiredNodes += expired;
+        return expired;
+    }
+
+    template <typename Func>
+    void each(const float radius, Func consumer, float percent = 1.0f) {
+        if (empty()) return;
+
+        percent = std::clamp(percent, 0.0f, 1.0f);
+
+        const float capSize = static_cast<float>(this->size() - 1) * percent;
 
         const float pos = (1 - percent) * size();
         const float ceil = std::floor(pos) + 1;
         const auto initial = static_cast<std::size_t>(ceil);
         const auto initialFloor = initial - 1;
         const auto prog = ceil - pos;
-        std::size_t index = initial;
 
-        if (index >= m_points.size()) return;
+        if (initial >= size()) return;
+
+        ++m_stats.frames;
+
+        // 第一段从插值节点开始，长度随 percent 变化，单独按标量计算
+        const TrailNode nodeFirst = node(initial);
+        const TrailNode nodeFloor = node(initialFloor);
+        const TrailNode nodeLerp{TrailNode::lerp(nodeFirst.pos, nodeFloor.pos, prog), std::lerp(nodeFirst.scale, nodeFloor.scale, prog)};
+
+        const float lastAngle = drawSegment(consumer, 0, nodeLerp, nodeFirst, 0, prog, 0.0f, radius, capSize);
+
+        const std::size_t count = size() - initial;
+        if (count < 2) return;
+        m_stats.reusedSegments += count - 1;
+
+        const float* length = m_cache.column(Length) + initial;
+        const float* dirX   = m_cache.column(DirX) + initial;
+        const float* dirY   = m_cache.column(DirY) + initial;
+        const float* scale  = m_cache.column(Scale) + initial;
+
+        const Keruis::Trail::SegmentOffsets out = m_offsets.output();
+        Keruis::Trail::computeOffsets({nullptr, nullptr, scale, count, radius, capSize, prog, lastAngle}, {length, dirX, dirY}, out);
+
+        // 两端偏移量都几乎为 0 的线段（锥形的尖端）不绘制；偏移量按列存放，两端的判定成批完成
+        const std::size_t segments = count - 1;
+        const std::span<std::uint8_t> startTiny(m_offsets.startTiny.data(), segments);
+        const std::span<std::uint8_t> endTiny(m_offsets.endTiny.data(), segments);
+        Keruis::Math::equals(Keruis::Math::ConstVec2Span(out.startX, out.startY, segments), {}, 0.01f, startTiny);
+        Keruis::Math::equals(Keruis::Math::ConstVec2Span(out.endX, out.endY, segments), {}, 0.01f, endTiny);
+
+        // 内核假定上一段总是被绘制；若上一段因 scale 为 0 被跳过，起点边需改用最近一次绘制的线段方向
+        float lastDirX = std::sin(lastAngle);
+        float lastDirY = std::cos(lastAngle);
+        bool  skipped  = false;
+
+        for (std::size_t k = 0; k < segments; ++k) {
+            if (scale[k] <= 0.001f && scale[k + 1] <= 0.001f) {
+                skipped = true;
+                continue;
+            }
 
-        TrailNode nodeNext = m_points[index];
-        TrailNode nodeCurrent{nodeCurrent.lerp(nodeNext.pos, m_points[initialFloor].pos, prog), std::lerp(nodeNext.scale, m_points[initialFloor].scale, prog)};
+            const float prevProg = static_cast<float>(k) + prog;
+            QPointF c(out.startX[k], out.startY[k]);
+            bool cTiny = startTiny[k] != 0;
+            if (skipped) {
+                const float scl = Keruis::Math::curve(length[k], 0.0f, 0.5f) * radius * scale[k] / capSize;
+                c = QPointF(lastDirX * scl * prevProg, lastDirY * scl * prevProg);
+                cTiny = Keruis::Math::equals(c, {}, 0.01f);
+                skipped = false;
+            }
 
-        lastAngle = drawImpl(0, nodeCurrent, nodeNext, 0, prog);
+            lastDirX = dirX[k];
+            lastDirY = dirY[k];
 
-        for (; index < m_points.size() - 1; ++index) {
-            nodeCurrent = m_points[index];
-            nodeNext = m_points[index + 1];
+            if (cTiny && endTiny[k]) continue;
 
-            if (nodeCurrent.scale <= 0.001f && nodeNext.scale <= 0.001f) continue;
+            const QPointF n(out.endX[k], out.endY[k]);
 
-            const float cur = index - initial + prog;
-            lastAngle = drawImpl(index - initialFloor, nodeCurrent, nodeNext, cur, cur + 1.0f);
+            const std::size_t index = initial + k;
+            dispatch(consumer, index - initialFloor, position(index), position(index + 1), c, n, prevProg, prevProg + 1.0f, capSize);
         }
     }
 
 private:
-    std::vector<TrailNode> m_points;
-    std::size_t m_capacity = 100;
+    // 缓存的列：第 i 行保存节点 i 的 scale 以及线段 (i, i + 1) 的几何；最新节点所在行的几何尚未确定。
+    // 角度只用于求方向，不缓存：each() 的起点边方向取自第一段（按标量计算）的角度或缓存的 DirX / DirY
+    enum CacheColumn : std::size_t { Length, DirX, DirY, Scale, CacheColumnCount };
+
+    // 每帧偏移量的输出缓冲（及两端偏移量是否几乎为 0 的标记），容量变化时才重新分配
+    struct OffsetBuffers {
+        std::vector<float> startX, startY, endX, endY;
+        std::vector<std::uint8_t> startTiny, endTiny;
+
+        void resize(std::size_t n) {
+            for (auto* v : {&startX, &startY, &endX, &endY}) {
+                v->resize(n);
+                v->shrink_to_fit();
+            }
+            for (auto* v : {&startTiny, &endTiny}) {
+                v->resize(n);
+                v->shrink_to_fit();
+            }
+        }
+
+        [[nodiscard]] Keruis::Trail::SegmentOffsets output() {
+            return {startX.data(), startY.data(), endX.data(), endY.data()};
+        }
+    };
+
+    void pushNode(const QPointF& pos, float scale, Clock::time_point time) {
+        if (m_storage == Storage::SoA) {
+            m_soa.push(pos, scale);
+        } else {
+            m_points.push(pos, scale);
+        }
+
+        m_times.push(time);
+        m_cache.pushRow();
+        m_cache.set(Scale, m_cache.size() - 1, scale);
+        if (m_cache.size() >= 2) updateSegment(m_cache.size() - 2);
+    }
+
+    // 有浮动节点时把它移到 pos（只重新计算最新的一个线段），否则追加一个节点
+    void placeNode(const QPointF& pos, float scale, Clock::time_point time) {
+        if (!m_floatingHead) {
+            pushNode(pos, scale, time);
+            return;
+        }
+
+        const std::size_t last = size() - 1;
+        if (m_storage == Storage::SoA) {
+            m_soa.set(last, pos, scale);
+        } else {
+            m_points.back() = TrailNode{pos, scale};
+        }
+        m_times.back() = time;
+        m_cache.set(Scale, last, scale);
+        if (last >= 1) updateSegment(last - 1);
+    }
+
+    void popFront() {
+        if (m_storage == Storage::SoA) {
+            m_soa.popFront();
+        } else {
+            m_points.popFront();
+        }
+        m_cache.popFront();
+        m_times.popFront();
+    }
+
+    [[nodiscard]] QPointF position(std::size_t i) const {
+        return m_storage == Storage::SoA ? QPointF(m_soa.x()[i], m_soa.y()[i]) : m_points[i].pos;
+    }
+
+    void updateSegment(std::size_t i) {
+        const QPointF dst = position(i + 1) - position(i);
+        const Keruis::Trail::SegmentDirection d = Keruis::Trail::direction(static_cast<float>(dst.x()), static_cast<float>(dst.y()));
+
+        m_cache.set(Length, i, d.length);
+        m_cache.set(DirX, i, d.dirX);
+        m_cache.set(DirY, i, d.dirY);
+        ++m_stats.computedSegments;
+    }
+
+    template <typename Func>
+    static void dispatch(
+        Func& consumer,
+        std::size_t index,
+        const QPointF& prev,
+        const QPointF& next,
+        const QPointF& c,
+        const QPointF& n,
+        const float prevProg,
+        const float nextProg,
+        const float capSize
+    ) {
+        if constexpr(std::invocable<Func, int, QPointF, QPointF, QPointF, QPointF, float, float>){
+            float progressFormer = prevProg / capSize;
+            float progressLatter = nextProg / capSize;
+
+            consumer(index, prev - c, prev + c, next + n, next - n, progressFormer, progressLatter);
+        } else if constexpr(std::invocable<Func, int, QPointF, QPointF, QPointF, QPointF>){
+            consumer(index, prev - c, prev + c, next + n, next - n);
+        } else if constexpr(std::invocable<Func, QPointF, QPointF, QPointF, QPointF, float, float>){
+            float progressFormer = prevProg / capSize;
+            float progressLatter = nextProg / capSize;
+
+            consumer(prev - c, prev + c, next + n, next - n, progressFormer, progressLatter);
+        } else if constexpr(std::invocable<Func, QPointF, QPointF, QPointF, QPointF>){
+            consumer(prev - c, prev + c, next + n, next - n);
+        } else{
+            qDebug() << "consumer not supported";
+        }
+    }
+
+    // 标量计算单个线段并回调，返回该线段的角度（作为下一段起点边的方向）
+    template <typename Func>
+    static float drawSegment(
+        Func& consumer,
+        std::size_t index,
+        const TrailNode& prev,
+        const TrailNode& next,
+        const float prevProg,
+        const float nextProg,
+        const float lastAngle,
+        const float radius,
+        const float capSize
+    ) {
+        const QPointF dst = next.pos - prev.pos;
+        const float scl = Keruis::Math::curve(static_cast<float>(std::sqrt(dst.x() * dst.x() + dst.y() * dst.y())), 0.0f, 0.5f) * radius * prev.scale / capSize;
+        const float z2 = static_cast<float>(std::atan2(-dst.y(), -dst.x()));
+
+        const float z1 = lastAngle;
+
+        const QPointF c = Keruis::Math::from_polar_rad<QPointF>(static_cast<float>(M_PI_2 - z1), scl * prevProg);
+        const QPointF n = Keruis::Math::from_polar_rad<QPointF>(static_cast<float>(M_PI_2 - z2), scl * nextProg);
+
+        if (Keruis::Math::equals(c, {}, 0.01f) && Keruis::Math::equals(n, {}, 0.01f)) {
+            return z2;
+        }
+
+        dispatch(consumer, index, prev.pos, next.pos, c, n, prevProg, nextProg, capSize);
+        return z2;
+    }
+
+    Storage                         m_storage;
+    RingBuffer<TrailNode>           m_points;
+    TrailSoA                        m_soa;
+    SoARing<CacheColumnCount>       m_cache;
+    RingBuffer<Clock::time_point>   m_times;
+    OffsetBuffers                   m_offsets;
+    Resampling                      m_resampling;
+    Stats                           m_stats;
+
+    QPointF                         m_lastInput;
+    double                          m_carry        = 0.0;     // 上一个固定节点到 m_lastInput 的折线长度
+    bool                            m_floatingHead = false;   // 最新节点是否为浮动节点
 };
 
 #endif //TRAILPATH_H
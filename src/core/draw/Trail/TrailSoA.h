@@ -0,0 +1,59 @@
+#ifndef TRAILSOA_H
+#define TRAILSOA_H
+
+#include <cstddef>
+
+#include <QPointF>
+
+#include "TrailNode.h"
+#include "../../container/SoARing.h"
+#include "../../../ext/math/vec2.h"
+
+// 拖尾节点的 SoA 存储：x / y / scale 各自连续存放（镜像环形缓冲，见 SoARing），
+// 任意时刻 [0, size) 的节点在内存中都是连续的，可以直接交给 SIMD 内核。
+class TrailSoA {
+public:
+    explicit TrailSoA(std::size_t capacity) : m_ring(capacity) {}
+
+    [[nodiscard]] auto size()     const -> std::size_t { return m_ring.size();     }
+    [[nodiscard]] auto capacity() const -> std::size_t { return m_ring.capacity(); }
+    [[nodiscard]] bool empty()    const                { return m_ring.empty();    }
+    [[nodiscard]] bool full()     const                { return m_ring.full();     }
+
+    void clear()                           { m_ring.clear();               }
+    void setCapacity(std::size_t capacity) { m_ring.setCapacity(capacity); }
+    void popFront()                        { m_ring.popFront();            }
+    void popBack()                         { m_ring.popBack();             }
+
+    // 满时覆盖最旧节点，返回是否发生了覆盖
+    bool push(const QPointF& pos, float scale) {
+        const bool evicted = m_ring.pushRow();
+        set(m_ring.size() - 1, pos, scale);
+        return evicted;
+    }
+
+    void set(std::size_t i, const QPointF& pos, float scale) {
+        m_ring.set(X, i, static_cast<float>(pos.x()));
+        m_ring.set(Y, i, static_cast<float>(pos.y()));
+        m_ring.set(Scale, i, scale);
+    }
+
+    [[nodiscard]] TrailNode operator[](std::size_t i) const {
+        return TrailNode{QPointF(m_ring.get(X, i), m_ring.get(Y, i)), m_ring.get(Scale, i)};
+    }
+
+    // 指向最旧节点的连续数组，长度为 size()
+    [[nodiscard]] const float* x()     const { return m_ring.column(X);     }
+    [[nodiscard]] const float* y()     const { return m_ring.column(Y);     }
+    [[nodiscard]] const float* scale() const { return m_ring.column(Scale); }
+
+    // 全部节点位置的视图，可直接交给 Keruis::Math 的批量函数
+    [[nodiscard]] Keruis::Math::ConstVec2Span positions() const { return {x(), y(), size()}; }
+
+private:
+    enum Column : std::size_t { X, Y, Scale, ColumnCount };
+
+    SoARing<ColumnCount> m_ring;
+};
+
+#endif //TRAILSOA_H
@@ -0,0 +1,197 @@
+#include "MenuFile.h"
+
+#include <span>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+
+static_assert(std::is_trivially_copyable_v<MenuTree::Node> && sizeof(MenuTree::Node) == 12,
+              "MenuTree::Node is written to and mapped from the compiled menu as is");
+static_assert(sizeof(MenuFile::Header) == 24);
+
+namespace MenuFile {
+
+    namespace {
+
+        constexpr std::uint32_t NoParent = ~std::uint32_t{0};
+
+        struct Entry {
+            std::string_view label;
+            std::uint32_t    parent;
+        };
+
+        std::string_view trimmed(std::string_view text) {
+            const auto first = text.find_first_not_of(" \t\r");
+            if (first == std::string_view::npos) return {};
+            const auto last = text.find_last_not_of(" \t\r");
+            return text.substr(first, last - first + 1);
+        }
+
+        // 文件大小与文件头中的各段长度一致时返回 true
+        bool validHeader(const Header& header, std::uint64_t fileSize) {
+            if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) return false;
+            if (header.version != Version || header.nodeCount == 0 || header.labelCount == 0) return false;
+
+            const std::uint64_t expected = sizeof(Header)
+                                         + std::uint64_t{header.nodeCount} * sizeof(MenuTree::Node)
+                                         + (std::uint64_t{header.labelCount} + 1) * sizeof(std::uint32_t)
+                                         + header.labelBytes;
+            return expected == fileSize;
+        }
+
+        // 标签偏移表首尾与字符段一致时返回 true；中间的偏移在取标签时逐个检查（MenuTree::labelText），加载时间与文件大小无关
+        bool validLabels(std::span<const std::uint32_t> offsets, std::uint32_t labelBytes) {
+            return offsets.front() == 0 && offsets.back() == labelBytes;
+        }
+
+    }
+
+    // 先按缩进确定每个条目的父条目，再按层序把各条目的子项成组追加到 MenuTree
+    bool parse(std::string_view text, MenuTree& tree, QString* error) {
+        std::vector<Entry> entries;
+        std::vector<std::pair<int, std::uint32_t>> stack;   // (缩进, 条目)，缩进严格递增
+
+        for (std::size_t pos = 0; pos < text.size(); ) {
+            std::size_t end = text.find('\n', pos);
+            if (end == std::string_view::npos) end = text.size();
+            const std::string_view line = text.substr(pos, end - pos);
+            pos = end + 1;
+
+            int indent = 0;
+            std::size_t i = 0;
+            for (; i < line.size() && (line[i] == ' ' || line[i] == '\t'); ++i) indent += line[i] == '\t' ? 4 : 1;
+
+            const std::string_view label = trimmed(line.substr(i));
+            if (label.empty() || label.front() == '#') continue;
+
+            while (!stack.empty() && stack.back().first >= indent) stack.pop_back();
+            entries.push_back({label, stack.empty() ? NoParent : stack.back().second});
+            stack.emplace_back(indent, static_cast<std::uint32_t>(entries.size() - 1));
+        }
+
+        if (entries.empty()) {
+            if (error) *error = QStringLiteral("menu definition has no entries");
+            return false;
+        }
+
+        // 按父条目分组（保持文件中的顺序）：条目 e 的子项为 order[begin[e + 1], begin[e + 2])，根为 e = -1
+        std::vector<std::uint32_t> begin(entries.size() + 2, 0);
+        for (const Entry& entry : entries) ++begin[entry.parent == NoParent ? 1 : entry.parent + 2];
+        for (std::size_t k = 1; k < begin.size(); ++k) begin[k] += begin[k - 1];
+
+        std::vector<std::uint32_t> order(entries.size());
+        std::vector<std::uint32_t> fill(begin.begin(), begin.end() - 1);
+        for (std::uint32_t e = 0; e < entries.size(); ++e) {
+            const Entry& entry = entries[e];
+            order[fill[entry.parent == NoParent ? 0 : entry.parent + 1]++] = e;
+        }
+
+        tree = MenuTree();
+        tree.reserve(entries.size() + 1);
+
+        // 层序：queue[k] 为第 k 个树节点对应的条目（根为 NoParent）
+        std::vector<std::uint32_t> queue;
+        queue.reserve(entries.size() + 1);
+        queue.push_back(NoParent);
+
+        for (std::size_t node = 0; node < queue.size(); ++node) {
+            const std::uint32_t group = queue[node] == NoParent ? 0 : queue[node] + 1;
+            const std::uint32_t count = begin[group + 1] - begin[group];
+            if (count == 0) continue;
+
+            const MenuTree::Index first = tree.appendChildren(static_cast<MenuTree::Index>(node), count);
+            for (std::uint32_t k = 0; k < count; ++k) {
+                const std::uint32_t e = order[begin[group] + k];
+                tree.setLabel(first + k, entries[e].label);
+                queue.push_back(e);
+            }
+        }
+
+        return true;
+    }
+
+    QByteArray compile(const MenuTree& tree) {
+        const std::span<const MenuTree::Node> nodes = tree.nodes();
+
+        Header header;
+        header.nodeCount = static_cast<std::uint32_t>(nodes.size());
+        header.labelCount = static_cast<std::uint32_t>(tree.labelCount());
+
+        std::vector<std::uint32_t> offsets;
+        offsets.reserve(header.labelCount + 1);
+        QByteArray chars;
+        for (std::uint32_t id = 0; id < header.labelCount; ++id) {
+            offsets.push_back(static_cast<std::uint32_t>(chars.size()));
+            const std::string_view label = tree.labelText(id);
+            chars.append(label.data(), static_cast<qsizetype>(label.size()));
+        }
+        offsets.push_back(static_cast<std::uint32_t>(chars.size()));
+        header.labelBytes = static_cast<std::uint32_t>(chars.size());
+
+        QByteArray out;
+        out.reserve(static_cast<qsizetype>(sizeof(Header) + nodes.size_bytes() + offsets.size() * sizeof(std::uint32_t)) + chars.size());
+        out.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+        out.append(reinterpret_cast<const char*>(nodes.data()), static_cast<qsizetype>(nodes.size_bytes()));
+        out.append(reinterpret_cast<const char*>(offsets.data()), static_cast<qsizetype>(offsets.size() * sizeof(std::uint32_t)));
+        out.append(chars);
+        return out;
+    }
+
+    // QFile 在映射期间保持打开，随 MenuTree 的 storage 一起释放
+    std::shared_ptr<const MenuTree> map(const QString& compiledPath) {
+        auto file = std::make_shared<QFile>(compiledPath);
+        if (!file->open(QIODevice::ReadOnly)) return nullptr;
+
+        const qint64 size = file->size();
+        if (size < static_cast<qint64>(sizeof(Header))) return nullptr;
+
+        const uchar* data = file->map(0, size);
+        if (!data) return nullptr;
+
+        Header header;
+        std::memcpy(&header, data, sizeof(Header));
+        if (!validHeader(header, static_cast<std::uint64_t>(size))) return nullptr;
+
+        const auto* nodes = reinterpret_cast<const MenuTree::Node*>(data + sizeof(Header));
+        const auto* offsets = reinterpret_cast<const std::uint32_t*>(nodes + header.nodeCount);
+        const auto* chars = reinterpret_cast<const char*>(offsets + header.labelCount + 1);
+
+        MenuTree::Labels labels{std::span(offsets, header.labelCount + 1), std::span(chars, header.labelBytes)};
+        if (!validLabels(labels.offsets, header.labelBytes)) return nullptr;
+        return std::make_shared<const MenuTree>(std::span(nodes, header.nodeCount), labels, std::move(file));
+    }
+
+    QString compiledPath(const QString& sourcePath) {
+        return sourcePath + QStringLiteral(".kmenu");
+    }
+
+    std::shared_ptr<const MenuTree> load(const QString& sourcePath, const QString& compiledPath, QString* error) {
+        const QFileInfo source(sourcePath);
+        const QFileInfo compiled(compiledPath);
+
+        if (compiled.exists() && (!source.exists() || compiled.lastModified() >= source.lastModified())) {
+            if (auto tree = map(compiledPath)) return tree;
+        }
+
+        QFile file(sourcePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            if (error) *error = QStringLiteral("cannot read %1: %2").arg(sourcePath, file.errorString());
+            return nullptr;
+        }
+        const QByteArray text = file.readAll();
+
+        MenuTree tree;
+        if (!parse(std::string_view(text.constData(), static_cast<std::size_t>(text.size())), tree, error)) return nullptr;
+
+        QSaveFile out(compiledPath);
+        if (out.open(QIODevice::WriteOnly) && out.write(compile(tree)) >= 0 && out.commit()) {
+            if (auto mapped = map(compiledPath)) return mapped;
+        }
+        return std::make_shared<const MenuTree>(std::move(tree));
+    }
+
+}
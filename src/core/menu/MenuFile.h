@@ -0,0 +1,59 @@
+#ifndef MENUFILE_H
+#define MENUFILE_H
+
+#include <memory>
+#include <cstdint>
+#include <string_view>
+
+#include <QString>
+#include <QByteArray>
+
+#include "MenuTree.h"
+
+// 菜单定义文件。
+//
+// 文本格式：每行一个条目，缩进比上一个条目深的行是它的子项（空格计 1 列，Tab 计 4 列），
+// 空行与以 # 开头的行被忽略，标签首尾的空白被去掉。例如
+//
+//     Apps
+//         Terminal
+//         Browser
+//     Files
+//
+// 编译格式（版本 Version，本机字节序，各段 4 字节对齐）：
+//     Header | Node[nodeCount] | uint32 labelOffsets[labelCount + 1] | char labels[labelBytes]
+// 节点按层序排列，与 MenuTree 的内存布局相同，映射后直接作为 MenuTree 的节点数组使用：
+// 加载只读取并校验文件头，与文件大小无关；子菜单所在的页在第一次展开（访问其子节点区间）时才由系统读入。
+namespace MenuFile {
+
+    constexpr char          Magic[4] = {'K', 'M', 'N', 'U'};
+    constexpr std::uint32_t Version  = 1;
+
+    struct Header {
+        char            magic[4]   = {Magic[0], Magic[1], Magic[2], Magic[3]};
+        std::uint32_t   version    = Version;
+        std::uint32_t   nodeCount  = 0;   // 含根
+        std::uint32_t   labelCount = 0;   // 含 Id 0 的空字符串
+        std::uint32_t   labelBytes = 0;
+        std::uint32_t   reserved   = 0;
+    };
+
+    // 文本定义 → MenuTree，失败时返回 false 并写入 error
+    bool parse(std::string_view text, MenuTree& tree, QString* error = nullptr);
+
+    QByteArray compile(const MenuTree& tree);
+
+    // 映射编译后的文件；文件不存在、文件头不符、大小或标签偏移表首尾不一致时返回 nullptr。
+    // 节点的子节点区间与标签 Id 不在加载时逐个检查，而是在访问时由 MenuTree 检查（越界按无子节点 / 空标签处理）
+    std::shared_ptr<const MenuTree> map(const QString& compiledPath);
+
+    // 源文件旁的编译缓存：<源文件>.kmenu
+    QString compiledPath(const QString& sourcePath);
+
+    // 编译结果存在且不比源文件旧时直接映射；否则重新编译并写入 compiledPath 后映射，
+    // 缓存无法写入时返回内存中的菜单树。源文件与缓存都不可用时返回 nullptr 并写入 error
+    std::shared_ptr<const MenuTree> load(const QString& sourcePath, const QString& compiledPath, QString* error = nullptr);
+
+}
+
+#endif //MENUFILE_H
@@ -0,0 +1,394 @@
+#ifndef MENUSEARCH_H
+#define MENUSEARCH_H
+
+#include <span>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <string_view>
+
+#include "MenuTree.h"
+
+// 菜单树全部标签的子串搜索（ASCII 不区分大小写，其余字节按原样比较）。
+//
+// 排名（越小越靠前）：完全相同 < 标签前缀 < 词首（前一个字符不是字母或数字）< 其他位置，同级再按深度、标签长度、节点下标。
+// 后三项与查询无关，构造时把节点按它们排好，得到静态名次 rank；一个匹配的排序键即 (级别, rank)。
+//
+// 索引为每个 1 / 2 / 3-gram 记录含有它的节点的 rank，按该 gram 在标签中的最好级别分为前缀、词首、其他三段，每段 rank 升序：
+//  - 查询不超过 3 个字节：完全相同的节点单独查表，其后三段依次就是排好的结果，只取前 limit 个，与匹配数无关；
+//  - 更长的查询：匹配对查询的级别不会好于对其第一个 3-gram 的级别，按三段顺序扫描第一个 3-gram 的倒排表，
+//    用大小为 limit 的堆保留最好的结果，当前位置的键已经大于堆中最差的键时后面不可能再进入前 limit，停止扫描；
+//    候选较少时（最稀有的 3-gram 倒排表，或逐键输入时上一次的全部匹配）直接全部验证。
+class MenuSearch {
+public:
+    explicit MenuSearch(std::shared_ptr<const MenuTree> tree) : m_tree(std::move(tree)) {
+        buildFolded();
+        buildTopology();
+        buildRanks();
+        buildExact();
+        buildIndex();
+    }
+
+    // 返回排名前 limit 的节点；查询为空时返回空
+    std::span<const MenuTree::Index> search(std::string_view query, std::size_t limit) {
+        std::string folded(query);
+        for (char& c : folded) c = fold(c);
+
+        const bool extends = m_complete && folded.size() > m_query.size() && folded.starts_with(m_query);
+        m_query = std::move(folded);
+        m_complete = false;
+        m_scanned = 0;
+        m_results.clear();
+        if (m_query.empty() || limit == 0) return {};
+
+        collectExact(limit);
+        if (m_query.size() <= 3) {
+            takeTiers(limit);
+        } else {
+            scan(limit, extends);
+        }
+        return m_results;
+    }
+
+    [[nodiscard]] auto results() const -> std::span<const MenuTree::Index> { return m_results; }
+
+    // 上一次查询检查过的候选数（不超过 3 个字节时为取出的倒排项数）
+    [[nodiscard]] auto scanned() const -> std::size_t { return m_scanned; }
+
+    [[nodiscard]] MenuTree::Index parent(MenuTree::Index node) const { return m_parents[node]; }
+    [[nodiscard]] int             depth (MenuTree::Index node) const { return m_depths[node];  }
+
+    // 从第 0 级到 node 每一级在父节点中的下标
+    void path(MenuTree::Index node, std::vector<int>& out) const {
+        out.assign(static_cast<std::size_t>(m_depths[node]) + 1, -1);
+        for (int level = m_depths[node]; level >= 0 && node != MenuTree::Root; --level) {
+            const MenuTree::Index parent = m_parents[node];
+            out[static_cast<std::size_t>(level)] = static_cast<int>(node - (*m_tree)[parent].firstChild);
+            node = parent;
+        }
+    }
+
+    [[nodiscard]] auto tree() const -> const std::shared_ptr<const MenuTree>& { return m_tree; }
+
+private:
+    using Rank = std::uint32_t;
+
+    enum Quality : int { Exact = 0, Prefix = 1, WordStart = 2, Inside = 3 };
+
+    // 全部验证的候选数上限，超过时改为按段扫描并提前停止
+    static constexpr std::size_t FullScanLimit = 8192;
+
+    // 一个 gram 的倒排表：tiers[t] 到 tiers[t + 1] 为级别 Prefix + t 的一段
+    struct Postings {
+        std::span<const Rank>   all;
+        std::size_t             tiers[4] = {};
+
+        [[nodiscard]] std::span<const Rank> tier(std::size_t t) const { return all.subspan(tiers[t], tiers[t + 1] - tiers[t]); }
+    };
+
+    static char fold(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+    static bool isWordChar(char c) { return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || (c & 0x80); }
+
+    // 高 8 位为长度，低 24 位为字节
+    static std::uint32_t gramKey(std::string_view gram) {
+        std::uint32_t key = static_cast<std::uint32_t>(gram.size()) << 24;
+        for (std::size_t i = 0; i < gram.size(); ++i) {
+            key |= static_cast<std::uint32_t>(static_cast<unsigned char>(gram[i])) << (8 * (gram.size() - 1 - i));
+        }
+        return key;
+    }
+
+    // query 在 text 中所有出现位置里最好的级别，不含 query 时返回 -1
+    static int quality(std::string_view text, std::string_view query) {
+        std::size_t pos = text.find(query);
+        if (pos == std::string_view::npos) return -1;
+        if (pos == 0) return text.size() == query.size() ? Exact : Prefix;
+        for (; pos != std::string_view::npos; pos = text.find(query, pos + 1)) {
+            if (!isWordChar(text[pos - 1])) return WordStart;
+        }
+        return Inside;
+    }
+
+    [[nodiscard]] std::string_view labelFolded(StringPool::Id id) const {
+        if (std::size_t{id} + 1 >= m_foldedOffsets.size()) return {};
+        return std::string_view(m_folded).substr(m_foldedOffsets[id], m_foldedOffsets[id + 1] - m_foldedOffsets[id]);
+    }
+
+    [[nodiscard]] std::string_view folded(Rank rank) const { return labelFolded(m_rankLabels[rank]); }
+
+    // 标签按 Id 折叠为小写后首尾相接
+    void buildFolded() {
+        const std::size_t labels = m_tree->labelCount();
+        m_foldedOffsets.reserve(labels + 1);
+        for (std::size_t id = 0; id < labels; ++id) {
+            m_foldedOffsets.push_back(static_cast<std::uint32_t>(m_folded.size()));
+            for (const char c : m_tree->labelText(static_cast<StringPool::Id>(id))) m_folded.push_back(fold(c));
+        }
+        m_foldedOffsets.push_back(static_cast<std::uint32_t>(m_folded.size()));
+    }
+
+    // 子节点总是追加在父节点之后，按下标顺序一趟即可得到深度
+    void buildTopology() {
+        const std::span<const MenuTree::Node> nodes = m_tree->nodes();
+        m_parents.assign(nodes.size(), MenuTree::Root);
+        m_depths.assign(nodes.size(), -1);
+
+        for (MenuTree::Index node = 0; node < nodes.size(); ++node) {
+            for (std::size_t i = 0; i < m_tree->children(node).size(); ++i) {
+                const MenuTree::Index child = nodes[node].firstChild + static_cast<MenuTree::Index>(i);
+                m_parents[child] = node;
+                m_depths[child] = m_depths[node] + 1;
+            }
+        }
+    }
+
+    // 静态名次：按 (深度, 标签长度, 节点下标) 排序，不在树中的节点不参与
+    void buildRanks() {
+        std::vector<std::uint64_t> keys;
+        keys.reserve(m_tree->size());
+        for (MenuTree::Index node = 1; node < m_depths.size(); ++node) {
+            if (m_depths[node] < 0) continue;
+            const std::size_t length = labelFolded(m_tree->labelId(node)).size();
+            keys.push_back((std::min<std::uint64_t>(static_cast<std::uint64_t>(m_depths[node]), 0xFFF) << 48)
+                         | (std::min<std::uint64_t>(length, 0xFFFF) << 32)
+                         | node);
+        }
+        std::ranges::sort(keys);
+
+        m_rankNodes.resize(keys.size());
+        m_rankLabels.resize(keys.size());
+        for (std::size_t rank = 0; rank < keys.size(); ++rank) {
+            m_rankNodes[rank] = static_cast<MenuTree::Index>(keys[rank]);
+            m_rankLabels[rank] = m_tree->labelId(m_rankNodes[rank]);
+        }
+    }
+
+    // 完全相同的查找表：非空标签按折叠后的文本排序，每个标签 Id 的节点 rank 升序（CSR）
+    void buildExact() {
+        const std::size_t labels = m_foldedOffsets.size() - 1;
+        for (std::size_t id = 0; id < labels; ++id) {
+            if (!labelFolded(static_cast<StringPool::Id>(id)).empty()) m_labelsByText.push_back(static_cast<StringPool::Id>(id));
+        }
+        std::ranges::sort(m_labelsByText, {}, [this](StringPool::Id id) { return labelFolded(id); });
+
+        m_labelRankOffsets.assign(labels + 1, 0);
+        for (const StringPool::Id id : m_rankLabels) ++m_labelRankOffsets[id + 1];
+        for (std::size_t id = 0; id < labels; ++id) m_labelRankOffsets[id + 1] += m_labelRankOffsets[id];
+
+        m_labelRanks.resize(m_rankLabels.size());
+        std::vector<std::uint32_t> fill(m_labelRankOffsets.begin(), m_labelRankOffsets.end() - 1);
+        for (Rank rank = 0; rank < m_rankLabels.size(); ++rank) m_labelRanks[fill[m_rankLabels[rank]]++] = rank;
+    }
+
+    // 每个标签 Id 去重后的 (gram, 最好级别) 只算一次；按 (gram, 级别) 计数排序，按 rank 顺序填入后每段自然升序
+    void buildIndex() {
+        const std::size_t labels = m_foldedOffsets.size() - 1;
+
+        std::vector<std::uint32_t> labelGrams;            // (gramKey << 2) | (级别 - Prefix)
+        std::vector<std::uint32_t> labelGramOffsets(labels + 1, 0);
+        std::vector<std::uint32_t> scratch;
+        for (std::size_t id = 0; id < labels; ++id) {
+            const std::string_view text = labelFolded(static_cast<StringPool::Id>(id));
+            scratch.clear();
+            for (std::size_t n = 1; n <= 3; ++n) {
+                for (std::size_t i = 0; i + n <= text.size(); ++i) {
+                    const std::uint32_t tier = i == 0 ? 0 : (isWordChar(text[i - 1]) ? 2 : 1);
+                    scratch.push_back((gramKey(text.substr(i, n)) << 2) | tier);
+                }
+            }
+            std::ranges::sort(scratch);
+            for (std::size_t i = 0; i < scratch.size(); ++i) {
+                if (i == 0 || (scratch[i] >> 2) != (scratch[i - 1] >> 2)) labelGrams.push_back(scratch[i]);
+            }
+            labelGramOffsets[id + 1] = static_cast<std::uint32_t>(labelGrams.size());
+        }
+
+        // 出现过的 (gram, 级别) 按值编号，编号即计数排序的桶：(值 << 32) | 在 labelGrams 中的位置，
+        // 值不超过 28 位，三趟 10 位的基数排序后顺序编号并写回 labelGrams
+        std::vector<std::uint64_t> order(labelGrams.size());
+        std::vector<std::uint64_t> sorted(labelGrams.size());
+        for (std::size_t i = 0; i < labelGrams.size(); ++i) order[i] = (std::uint64_t{labelGrams[i]} << 32) | i;
+        for (int shift = 32; shift < 62; shift += 10) {
+            std::array<std::uint32_t, 1025> digits{};
+            for (const std::uint64_t v : order) ++digits[((v >> shift) & 1023) + 1];
+            for (std::size_t d = 0; d < 1024; ++d) digits[d + 1] += digits[d];
+            for (const std::uint64_t v : order) sorted[digits[(v >> shift) & 1023]++] = v;
+            order.swap(sorted);
+        }
+
+        std::vector<std::uint32_t> buckets;
+        for (const std::uint64_t v : order) {
+            const auto gram = static_cast<std::uint32_t>(v >> 32);
+            if (buckets.empty() || buckets.back() != gram) buckets.push_back(gram);
+            labelGrams[static_cast<std::uint32_t>(v)] = static_cast<std::uint32_t>(buckets.size() - 1);
+        }
+
+        std::vector<std::uint32_t> counts(buckets.size() + 1, 0);
+        for (const StringPool::Id id : m_rankLabels) {
+            for (std::uint32_t i = labelGramOffsets[id]; i < labelGramOffsets[id + 1]; ++i) ++counts[labelGrams[i] + 1];
+        }
+        for (std::size_t b = 0; b < buckets.size(); ++b) counts[b + 1] += counts[b];
+
+        m_postings.resize(counts.back());
+        std::vector<std::uint32_t> fill(counts.begin(), counts.end() - 1);
+        for (Rank rank = 0; rank < m_rankLabels.size(); ++rank) {
+            const StringPool::Id id = m_rankLabels[rank];
+            for (std::uint32_t i = labelGramOffsets[id]; i < labelGramOffsets[id + 1]; ++i) m_postings[fill[labelGrams[i]]++] = rank;
+        }
+
+        // 同一 gram 的三个级别在 buckets 中相邻；缺少的级别为空段
+        for (std::size_t b = 0; b < buckets.size(); ++b) {
+            const std::uint32_t key = buckets[b] >> 2;
+            if (m_keys.empty() || m_keys.back() != key) {
+                m_keys.push_back(key);
+                m_offsets.insert(m_offsets.end(), 3, counts[b]);
+            }
+            const std::size_t base = (m_keys.size() - 1) * 3;
+            for (std::uint32_t t = (buckets[b] & 3) + 1; t < 3; ++t) m_offsets[base + t] = counts[b + 1];
+        }
+        m_offsets.push_back(counts.back());
+    }
+
+    [[nodiscard]] Postings postings(std::string_view gram) const {
+        const std::uint32_t key = gramKey(gram);
+        const auto it = std::ranges::lower_bound(m_keys, key);
+        if (it == m_keys.end() || *it != key) return {};
+
+        const std::size_t k = static_cast<std::size_t>(it - m_keys.begin()) * 3;
+        Postings list;
+        list.all = std::span<const Rank>(m_postings).subspan(m_offsets[k], m_offsets[k + 3] - m_offsets[k]);
+        for (std::size_t t = 0; t < 4; ++t) list.tiers[t] = m_offsets[k + t] - m_offsets[k];
+        return list;
+    }
+
+    void take(Rank rank) { m_results.push_back(m_rankNodes[rank]); }
+
+    // 完全相同的节点排在最前；后面的步骤遇到它们时跳过
+    void collectExact(std::size_t limit) {
+        const auto [first, last] = std::ranges::equal_range(m_labelsByText, std::string_view(m_query), {},
+                                                            [this](StringPool::Id id) { return labelFolded(id); });
+        m_exact.clear();
+        for (auto it = first; it != last; ++it) {
+            m_exact.insert(m_exact.end(), m_labelRanks.begin() + m_labelRankOffsets[*it], m_labelRanks.begin() + m_labelRankOffsets[*it + 1]);
+        }
+        if (last - first > 1) std::ranges::sort(m_exact);
+        for (std::size_t i = 0; i < m_exact.size() && m_results.size() < limit; ++i) take(m_exact[i]);
+    }
+
+    // 查询本身就是一个 gram：三段依次取出，前缀段中长度相同的就是已经取出的完全相同的节点
+    void takeTiers(std::size_t limit) {
+        const Postings list = postings(m_query);
+        for (const Rank rank : list.all) {
+            if (m_results.size() >= limit) return;
+            ++m_scanned;
+            if (m_scanned <= list.tiers[1] && folded(rank).size() == m_query.size()) continue;
+            take(rank);
+        }
+    }
+
+    void scan(std::size_t limit, bool extends) {
+        const Postings first = postings(std::string_view(m_query).substr(0, 3));
+        if (first.all.empty()) return;
+
+        std::span<const Rank> candidates = first.all;
+        for (std::size_t i = 1; i + 3 <= m_query.size(); ++i) {
+            const Postings list = postings(std::string_view(m_query).substr(i, 3));
+            if (list.all.empty()) return;
+            if (list.all.size() < candidates.size()) candidates = list.all;
+        }
+        if (extends && m_matches.size() < candidates.size()) candidates = m_matches;
+
+        if (candidates.size() <= FullScanLimit) {
+            verifyAll(candidates, limit);
+        } else {
+            scanTiers(first, limit);
+        }
+    }
+
+    // 验证全部候选并保留完整的匹配集合，供下一次逐键筛选
+    void verifyAll(std::span<const Rank> candidates, std::size_t limit) {
+        m_ranked.clear();
+        m_next.clear();
+        for (const Rank rank : candidates) {
+            const int q = quality(folded(rank), m_query);
+            if (q < 0) continue;
+            m_next.push_back(rank);
+            if (q != Exact) m_ranked.push_back((static_cast<std::uint64_t>(q) << 32) | rank);
+        }
+        m_scanned = candidates.size();
+        m_matches.swap(m_next);
+        m_complete = true;
+
+        const std::size_t count = std::min(limit - m_results.size(), m_ranked.size());
+        std::ranges::nth_element(m_ranked, m_ranked.begin() + static_cast<std::ptrdiff_t>(count));
+        std::sort(m_ranked.begin(), m_ranked.begin() + static_cast<std::ptrdiff_t>(count));
+        for (std::size_t i = 0; i < count; ++i) take(static_cast<Rank>(m_ranked[i]));
+    }
+
+    // 第 t 段中的节点对查询的级别不小于 Prefix + t，段内 rank 升序，因此扫描位置的键 (Prefix + t, rank) 单调不减
+    void scanTiers(const Postings& first, std::size_t limit) {
+        const std::size_t wanted = limit - m_results.size();
+        m_ranked.clear();
+        if (wanted == 0) return;
+
+        bool settled = false;
+        for (std::size_t t = 0; t < 3 && !settled; ++t) {
+            const std::uint64_t floor = static_cast<std::uint64_t>(Prefix + t) << 32;
+            for (const Rank rank : first.tier(t)) {
+                if (m_ranked.size() == wanted && m_ranked.front() < (floor | rank)) {
+                    settled = true;
+                    break;
+                }
+                ++m_scanned;
+
+                const int q = quality(folded(rank), m_query);
+                if (q <= Exact) continue;
+                const std::uint64_t key = (static_cast<std::uint64_t>(q) << 32) | rank;
+                if (m_ranked.size() < wanted) {
+                    m_ranked.push_back(key);
+                    std::ranges::push_heap(m_ranked);
+                } else if (key < m_ranked.front()) {
+                    std::ranges::pop_heap(m_ranked);
+                    m_ranked.back() = key;
+                    std::ranges::push_heap(m_ranked);
+                }
+            }
+        }
+        std::ranges::sort_heap(m_ranked);
+        for (const std::uint64_t key : m_ranked) take(static_cast<Rank>(key));
+    }
+
+    std::shared_ptr<const MenuTree>     m_tree;
+
+    std::string                         m_folded;
+    std::vector<std::uint32_t>          m_foldedOffsets;      // 按标签 Id
+    std::vector<MenuTree::Index>        m_parents;
+    std::vector<int>                    m_depths;             // 第 0 级为 0，根为 -1
+
+    std::vector<MenuTree::Index>        m_rankNodes;          // rank → 节点
+    std::vector<StringPool::Id>         m_rankLabels;         // rank → 标签 Id
+    std::vector<StringPool::Id>         m_labelsByText;       // 非空标签，按折叠后的文本排序
+    std::vector<std::uint32_t>          m_labelRankOffsets;   // 标签 Id → m_labelRanks 中的一段
+    std::vector<Rank>                   m_labelRanks;
+
+    std::vector<std::uint32_t>          m_keys;               // 已排序的 gram
+    std::vector<std::uint32_t>          m_offsets;            // 每个 gram 三段的起点，最后一项为总数
+    std::vector<Rank>                   m_postings;
+
+    std::string                         m_query;              // 上一次的查询（已折叠）
+    bool                                m_complete = false;   // m_matches 是否为上一次查询的全部匹配
+    std::vector<Rank>                   m_matches;
+    std::vector<Rank>                   m_next;
+    std::vector<Rank>                   m_exact;
+    std::vector<std::uint64_t>          m_ranked;             // (级别 << 32) | rank
+    std::vector<MenuTree::Index>        m_results;
+    std::size_t                         m_scanned = 0;
+};
+
+#endif //MENUSEARCH_H
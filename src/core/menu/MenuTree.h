@@ -0,0 +1,125 @@
+#ifndef MENUTREE_H
+#define MENUTREE_H
+
+#include <span>
+#include <memory>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <string_view>
+
+#include "../container/StringPool.h"
+
+// 扁平菜单树：所有节点放在一个连续数组里，每个节点的子节点在数组中连续，以 [firstChild, firstChild + childCount) 表示；
+// 标签驻留在 StringPool 中，节点只保存 Id。节点 0 是不显示的根，它的子节点是第 0 级菜单。
+//
+// 子节点必须通过 appendChildren 一次性追加，之后不能再增加；按层序（广度优先）生成时整棵树只需一趟，
+// 节点数组之外没有任何逐节点的分配。
+//
+// 也可以直接引用外部的只读内存（MenuFile 映射的编译菜单）：节点数组与标签表不复制，storage 保证其生命周期。
+// 外部数据没有整体校验，访问时逐项检查下标，越界的子节点区间视为空、越界的标签视为空字符串。
+class MenuTree {
+public:
+    using Index = std::uint32_t;
+
+    static constexpr Index Root = 0;
+
+    struct Node {
+        StringPool::Id  label      = 0;
+        Index           firstChild = 0;
+        Index           childCount = 0;
+    };
+
+    // 引用外部内存时的标签表：第 id 个标签为 chars[offsets[id], offsets[id + 1])
+    struct Labels {
+        std::span<const std::uint32_t>  offsets;
+        std::span<const char>           chars;
+    };
+
+    MenuTree() : m_nodes(1) {}
+
+    MenuTree(std::span<const Node> nodes, Labels labels, std::shared_ptr<const void> storage)
+        : m_mappedNodes(nodes), m_mappedLabels(labels), m_storage(std::move(storage)) {}
+
+    void reserve(std::size_t nodes) { m_nodes.reserve(nodes); }
+
+    // 为 parent 追加 count 个空标签的子节点，返回第一个子节点的下标
+    Index appendChildren(Index parent, std::size_t count) {
+        assert(!mapped() && "a mapped menu tree is read-only");
+        assert(m_nodes[parent].childCount == 0 && "children of a node must be appended at once");
+
+        const auto first = static_cast<Index>(m_nodes.size());
+        m_nodes.resize(m_nodes.size() + count);
+        m_nodes[parent].firstChild = first;
+        m_nodes[parent].childCount = static_cast<Index>(count);
+        return first;
+    }
+
+    void setLabel(Index node, std::string_view label) { m_nodes[node].label = m_strings.intern(label); }
+
+    // 含根
+    [[nodiscard]] std::span<const Node> nodes() const { return mapped() ? m_mappedNodes : std::span<const Node>(m_nodes); }
+
+    [[nodiscard]] const Node& operator[](Index node) const { return nodes()[node]; }
+
+    [[nodiscard]] std::span<const Node> children(Index node) const {
+        const std::span<const Node> all = nodes();
+        const Node& n = all[node];
+        if (n.firstChild > all.size() || n.childCount > all.size() - n.firstChild) return {};
+        return all.subspan(n.firstChild, n.childCount);
+    }
+
+    // parent 的第 i 个子节点，越界时返回 Root
+    [[nodiscard]] Index child(Index parent, std::size_t i) const {
+        const std::span<const Node> range = children(parent);
+        return i < range.size() ? nodes()[parent].firstChild + static_cast<Index>(i) : Root;
+    }
+
+    [[nodiscard]] std::string_view label(const Node& node) const { return labelText(node.label); }
+    [[nodiscard]] std::string_view label(Index node)       const { return label(nodes()[node]); }
+
+    [[nodiscard]] std::string_view labelText(StringPool::Id id) const {
+        if (!mapped()) return m_strings.view(id);
+
+        const auto& [offsets, chars] = m_mappedLabels;
+        if (std::size_t{id} + 1 >= offsets.size()) return {};
+        const std::uint32_t begin = offsets[id], end = offsets[id + 1];
+        if (begin > end || end > chars.size()) return {};
+        return {chars.data() + begin, end - begin};
+    }
+
+    // 标签数（含 Id 0 的空字符串）
+    [[nodiscard]] std::size_t labelCount() const {
+        return mapped() ? (m_mappedLabels.offsets.empty() ? 0 : m_mappedLabels.offsets.size() - 1) : m_strings.size();
+    }
+
+    // 节点的标签 Id，保证小于 labelCount()：映射的文件中超出标签表的 Id 按空字符串（Id 0）处理，
+    // 用 Id 作下标的表（搜索索引等）应通过这里取 Id
+    [[nodiscard]] StringPool::Id labelId(Index node) const {
+        const StringPool::Id id = nodes()[node].label;
+        return std::size_t{id} < labelCount() ? id : StringPool::Id{0};
+    }
+
+    [[nodiscard]] bool mapped() const { return !m_mappedNodes.empty(); }
+
+    // 不含根
+    [[nodiscard]] auto size()  const -> std::size_t { return nodes().size() - 1; }
+    [[nodiscard]] bool empty() const                { return nodes()[Root].childCount == 0; }
+
+    // 自身占用的堆内存，不含引用的外部内存
+    [[nodiscard]] std::size_t memoryUsage() const {
+        return m_nodes.capacity() * sizeof(Node) + m_strings.memoryUsage();
+    }
+
+private:
+    std::vector<Node>               m_nodes;
+    StringPool                      m_strings;
+
+    std::span<const Node>           m_mappedNodes;
+    Labels                          m_mappedLabels;
+    std::shared_ptr<const void>     m_storage;
+};
+
+#endif //MENUTREE_H
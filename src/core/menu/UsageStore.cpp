@@ -0,0 +1,112 @@
+#include "UsageStore.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#include <QFile>
+#include <QSaveFile>
+
+static_assert(std::is_trivially_copyable_v<UsageStore::Entry> && sizeof(UsageStore::Entry) == 16,
+              "UsageStore::Entry is written to and read from the usage file as is");
+static_assert(sizeof(UsageStore::Header) == 16);
+
+double UsageStore::increment(std::int64_t now) const {
+    return std::exp2(static_cast<double>(now - base()) / HalfLife);
+}
+
+void UsageStore::rebase(std::int64_t now) {
+    const double exponent = static_cast<double>(now - base()) / HalfLife;
+    if (exponent <= RebaseAfter) return;
+
+    const auto shift = static_cast<int>(exponent);
+    for (Entry& entry : m_entries) entry.weight = std::ldexp(entry.weight, -shift);
+    m_epochShift += static_cast<std::uint32_t>(shift);
+}
+
+void UsageStore::record(Key key, std::int64_t now) {
+    rebase(now);
+    const auto it = std::ranges::lower_bound(m_entries, key, {}, &Entry::key);
+    if (it != m_entries.end() && it->key == key) {
+        it->weight += increment(now);
+    } else {
+        m_entries.insert(it, Entry{key, increment(now)});
+    }
+    m_dirty = true;
+}
+
+double UsageStore::weight(Key key) const {
+    const auto it = std::ranges::lower_bound(m_entries, key, {}, &Entry::key);
+    return (it != m_entries.end() && it->key == key) ? it->weight : 0.0;
+}
+
+std::shared_ptr<const UsageStore::Order> UsageStore::order(const MenuTree& tree, MenuTree::Index parent, Key parentKey) const {
+    if (m_entries.empty()) return nullptr;
+
+    // 先找到第一个有记录的子项，全部没有记录时不分配内存
+    const std::span<const MenuTree::Node> children = tree.children(parent);
+    std::size_t first = 0;
+    while (first < children.size() && weight(childKey(parentKey, tree.label(children[first]))) <= 0.0) ++first;
+    if (first == children.size()) return nullptr;
+
+    std::vector<double> weights(children.size(), 0.0);
+    for (std::size_t i = first; i < children.size(); ++i) weights[i] = weight(childKey(parentKey, tree.label(children[i])));
+
+    auto order = std::make_shared<Order>();
+    order->items.resize(children.size());
+    for (std::size_t i = 0; i < children.size(); ++i) order->items[i] = static_cast<MenuTree::Index>(i);
+    std::ranges::stable_sort(order->items, [&](MenuTree::Index a, MenuTree::Index b) { return weights[a] > weights[b]; });
+
+    order->positions.resize(children.size());
+    for (std::size_t k = 0; k < children.size(); ++k) order->positions[order->items[k]] = static_cast<MenuTree::Index>(k);
+    return order;
+}
+
+bool UsageStore::deserialize(const QByteArray& data) {
+    Header header;
+    if (data.size() < static_cast<qsizetype>(sizeof(Header))) return false;
+    std::memcpy(&header, data.constData(), sizeof(Header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version) return false;
+    if (static_cast<std::uint64_t>(data.size()) != sizeof(Header) + std::uint64_t{header.count} * sizeof(Entry)) return false;
+
+    std::vector<Entry> entries(header.count);
+    std::memcpy(entries.data(), data.constData() + sizeof(Header), entries.size() * sizeof(Entry));
+    if (!std::ranges::is_sorted(entries, {}, &Entry::key)) std::ranges::sort(entries, {}, &Entry::key);
+
+    m_entries = std::move(entries);
+    m_epochShift = header.epochShift;
+    m_dirty = false;
+    return true;
+}
+
+QByteArray UsageStore::serialize() {
+    if (m_entries.size() > MaxEntries) {
+        std::ranges::nth_element(m_entries, m_entries.begin() + MaxEntries, std::ranges::greater{}, &Entry::weight);
+        m_entries.resize(MaxEntries);
+        std::ranges::sort(m_entries, {}, &Entry::key);
+    }
+
+    Header header;
+    header.count = static_cast<std::uint32_t>(m_entries.size());
+    header.epochShift = m_epochShift;
+
+    QByteArray out;
+    out.reserve(static_cast<qsizetype>(sizeof(Header) + m_entries.size() * sizeof(Entry)));
+    out.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+    out.append(reinterpret_cast<const char*>(m_entries.data()), static_cast<qsizetype>(m_entries.size() * sizeof(Entry)));
+
+    m_dirty = false;
+    return out;
+}
+
+bool UsageStore::load(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    return deserialize(file.readAll());
+}
+
+bool UsageStore::write(const QString& path, const QByteArray& data) {
+    QSaveFile out(path);
+    return out.open(QIODevice::WriteOnly) && out.write(data) == data.size() && out.commit();
+}
@@ -0,0 +1,107 @@
+#ifndef USAGESTORE_H
+#define USAGESTORE_H
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+#include <QString>
+#include <QByteArray>
+
+#include "MenuTree.h"
+
+// 菜单条目的使用频率：按菜单路径（从第 0 级到该条目的标签序列）的 64 位哈希计数，与节点下标无关，
+// 菜单文件重新编译或条目顺序变化后仍然有效。
+//
+// 计数随时间指数衰减（半衰期 HalfLife）。每次选中累加 2^((t - base) / HalfLife)，
+// 即把所有计数换算到同一基准时刻，比较两个条目时不需要按当前时间重新衰减。
+// 指数每年约增加 12，double 约 84 年后溢出：指数超过 RebaseAfter 时基准前移 k 个整半衰期、所有权重乘以 2^-k，
+// 缩放是精确的，不改变任何比较；基准 = Epoch + epochShift * HalfLife，epochShift 保存在文件头中。
+// 条目按键排序放在一个数组里（每项 16 字节），查找为二分。
+//
+// 文件格式（版本 Version，本机字节序）：Header | Entry[count]
+class UsageStore {
+public:
+    using Key = std::uint64_t;
+
+    static constexpr char           Magic[4]   = {'K', 'U', 'S', 'G'};
+    static constexpr std::uint32_t  Version    = 1;
+    static constexpr std::int64_t   Epoch      = 1704067200;           // 2024-01-01 UTC
+    static constexpr double         HalfLife   = 30.0 * 24 * 3600;     // 秒
+    static constexpr std::size_t    MaxEntries = 4096;                 // 超出时保存前丢弃权重最小的条目
+    static constexpr double         RebaseAfter = 64.0;                // 半衰期数，约 5 年
+
+    struct Header {
+        char            magic[4] = {Magic[0], Magic[1], Magic[2], Magic[3]};
+        std::uint32_t   version  = Version;
+        std::uint32_t   count      = 0;
+        std::uint32_t   epochShift = 0;   // 基准相对 Epoch 的半衰期数，旧文件中为 0
+    };
+
+    struct Entry {
+        Key     key    = 0;
+        double  weight = 0.0;
+    };
+
+    // 一层条目的显示顺序：按权重从大到小，权重相同（包括从未使用）时保持菜单中的顺序
+    struct Order {
+        std::vector<MenuTree::Index>    items;       // 第 k 个位置显示的子项下标
+        std::vector<MenuTree::Index>    positions;   // 子项下标 → 位置
+    };
+
+    static constexpr Key RootKey = 0xcbf29ce484222325ull;
+
+    // parent 路径下标签为 label 的子项的键（FNV-1a，标签之间插入分隔字节）
+    [[nodiscard]] static Key childKey(Key parent, std::string_view label) {
+        Key key = parent ^ 0x1f;
+        key *= 0x100000001b3ull;
+        for (const char c : label) {
+            key ^= static_cast<unsigned char>(c);
+            key *= 0x100000001b3ull;
+        }
+        return key;
+    }
+
+    // 基准时刻（秒）
+    [[nodiscard]] std::int64_t base() const { return Epoch + static_cast<std::int64_t>(m_epochShift) * static_cast<std::int64_t>(HalfLife); }
+
+    // now 时刻选中一次的增量
+    [[nodiscard]] double increment(std::int64_t now) const;
+
+    void record(Key key, std::int64_t now);
+
+    // 换算到基准时刻的权重，没有记录时为 0
+    [[nodiscard]] double weight(Key key) const;
+
+    // parent（键为 parentKey）的子项的显示顺序；所有子项都没有记录时返回 nullptr，即菜单中的顺序
+    [[nodiscard]] std::shared_ptr<const Order> order(const MenuTree& tree, MenuTree::Index parent, Key parentKey) const;
+
+    [[nodiscard]] auto size()  const -> std::size_t { return m_entries.size(); }
+    [[nodiscard]] bool dirty() const                { return m_dirty; }
+
+    // serialize 的结果没有写入成功时调用，下次保存时重试
+    void markDirty() { m_dirty = true; }
+
+    // 替换为 data 中的记录，格式不符时返回 false 且不修改
+    bool deserialize(const QByteArray& data);
+
+    // 当前记录的文件内容（超出 MaxEntries 时先丢弃权重最小的条目），同时清除 dirty
+    QByteArray serialize();
+
+    bool load(const QString& path);
+
+    // 原子写入（QSaveFile），可在任意线程调用
+    static bool write(const QString& path, const QByteArray& data);
+
+private:
+    // now 的指数超过 RebaseAfter 时前移基准
+    void rebase(std::int64_t now);
+
+    std::vector<Entry>      m_entries;   // 按 key 升序
+    std::uint32_t           m_epochShift = 0;
+    bool                    m_dirty = false;
+};
+
+#endif //USAGESTORE_H
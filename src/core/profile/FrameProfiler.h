@@ -0,0 +1,331 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <string_view>
+#include <initializer_list>
+
+#include "../container/RingBuffer.h"
+
+// 逐帧计时：paintEvent 中用 Frame 包住一帧，各绘制函数用 Scope 包住自身。
+// 保存最近 window 帧的记录（每帧各区段的耗时、update() 请求数、存活的动画数、重绘像素数、输入延迟、丢弃的帧数）与区段事件，
+// 可以按区段统计分位数 / 直方图，并导出为 Chrome trace JSON（chrome://tracing、Perfetto）或 CSV。
+// 关闭时 Frame / Scope 只读取一次 enabled 标志，不调用时钟。
+class FrameProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t DefaultWindow = 240;
+    static constexpr std::size_t MaxSections   = 16;
+
+    // 直方图桶的上界（微秒），最后一个桶收集超过 16 ms 的帧
+    static constexpr std::array<double, 9> BucketEdgesUs = {50, 100, 250, 500, 1000, 2000, 4000, 8000, 16000};
+    static constexpr std::size_t BucketCount = BucketEdgesUs.size() + 1;
+
+    using Histogram = std::array<std::size_t, BucketCount>;
+
+    // 区段编号 FrameSection 表示整帧，LatencySection 表示输入到绘制的延迟（只统计记录了延迟的帧）
+    static constexpr std::uint32_t FrameSection   = MaxSections;
+    static constexpr std::uint32_t LatencySection = MaxSections + 1;
+
+    struct FrameRecord {
+        std::uint64_t                      index          = 0;
+        double                             startUs        = 0.0;
+        double                             totalUs        = 0.0;
+        std::uint32_t                      updateRequests = 0;   // 上一帧结束到本帧结束之间的 update() 请求数
+        std::uint32_t                      animations     = 0;
+        std::uint64_t                      paintedPixels  = 0;   // 本帧重绘区域的面积（逻辑像素）
+        float                              inputLatencyUs = -1;  // 本帧呈现的最早一次输入到本帧绘制的时间，没有输入为 -1
+        std::uint32_t                      droppedFrames  = 0;   // 上一帧到本帧之间生成了但没有呈现的帧数（后台绘制）
+        std::array<float, MaxSections>     sectionUs{};          // 本帧未执行的区段为 -1
+    };
+
+    struct Event {
+        std::uint32_t section    = 0;
+        double        startUs    = 0.0;
+        double        durationUs = 0.0;
+    };
+
+    struct Summary {
+        std::size_t samples = 0;
+        double      p50Us   = 0.0;
+        double      p95Us   = 0.0;
+        double      maxUs   = 0.0;
+    };
+
+    class Scope {
+    public:
+        Scope(FrameProfiler& profiler, std::uint32_t section)
+            : m_profiler(profiler.m_enabled ? &profiler : nullptr), m_section(section)
+        {
+            if (m_profiler) m_start = Clock::now();
+        }
+
+        ~Scope() {
+            if (m_profiler) m_profiler->record(m_section, m_start, Clock::now());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameProfiler*    m_profiler;
+        std::uint32_t     m_section;
+        Clock::time_point m_start{};
+    };
+
+    class Frame {
+    public:
+        explicit Frame(FrameProfiler& profiler) : m_profiler(profiler.m_enabled ? &profiler : nullptr) {
+            if (m_profiler) m_profiler->beginFrame();
+        }
+
+        ~Frame() {
+            if (m_profiler) m_profiler->endFrame();
+        }
+
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+
+    private:
+        FrameProfiler* m_profiler;
+    };
+
+    // 区段编号按 sections 的顺序从 0 开始，最多 MaxSections 个
+    explicit FrameProfiler(std::initializer_list<std::string_view> sections, std::size_t window = DefaultWindow)
+        : m_frames(window), m_events(window * 4)
+    {
+        for (const auto name : sections) {
+            if (m_sectionNames.size() == MaxSections) break;
+            m_sectionNames.emplace_back(name);
+        }
+    }
+
+    [[nodiscard]] bool enabled() const { return m_enabled; }
+    void setEnabled(bool enabled) {
+        if (enabled && !m_enabled) m_epoch = Clock::now();
+        m_enabled = enabled;
+        m_inFrame = false;
+    }
+
+    void clear() {
+        m_frames.clear();
+        m_events.clear();
+        m_frameCount = 0;
+        m_pendingRequests = 0;
+        m_totalRequests = 0;
+        m_totalPaintedPixels = 0;
+    }
+
+    [[nodiscard]] auto sectionCount() const -> std::size_t { return m_sectionNames.size(); }
+    [[nodiscard]] auto sectionName(std::uint32_t section) const -> const std::string& {
+        static const std::string frame = "frame";
+        return section < m_sectionNames.size() ? m_sectionNames[section] : frame;
+    }
+
+    // update() 请求计数不受 enabled 影响，开启前的请求会计入第一帧
+    void countUpdateRequest() {
+        ++m_pendingRequests;
+        ++m_totalRequests;
+    }
+
+    // 在 Frame 的生命周期内调用，记录本帧存活的动画数
+    void setAnimationsAlive(std::uint32_t count) { m_current.animations = count; }
+
+    // 在 Frame 的生命周期内调用，记录本帧 paintEvent 的重绘区域面积
+    void setPaintedPixels(std::uint64_t pixels) {
+        m_current.paintedPixels = pixels;
+        m_totalPaintedPixels += pixels;
+    }
+
+    // 在 Frame 的生命周期内调用，记录本帧的输入延迟与上一帧之后丢弃的帧数
+    void setInputLatency(double us)             { m_current.inputLatencyUs = static_cast<float>(us); }
+    void setDroppedFrames(std::uint32_t count)  { m_current.droppedFrames = count; }
+
+    [[nodiscard]] auto frames()        const -> const RingBuffer<FrameRecord>& { return m_frames; }
+    [[nodiscard]] auto events()        const -> const RingBuffer<Event>&       { return m_events; }
+    [[nodiscard]] auto frameCount()    const -> std::uint64_t                  { return m_frameCount; }
+    [[nodiscard]] auto totalRequests() const -> std::uint64_t                  { return m_totalRequests; }
+
+    // clear() 以来所有帧（不限于窗口内）重绘区域面积之和
+    [[nodiscard]] auto totalPaintedPixels() const -> std::uint64_t { return m_totalPaintedPixels; }
+
+    // 窗口内平均每次绘制对应的 update() 请求数
+    [[nodiscard]] double requestsPerPaint() const {
+        if (m_frames.empty()) return 0.0;
+        double requests = 0.0;
+        for (const auto& frame : m_frames) requests += frame.updateRequests;
+        return requests / static_cast<double>(m_frames.size());
+    }
+
+    [[nodiscard]] double paintedPixelsPerFrame() const {
+        if (m_frames.empty()) return 0.0;
+        double pixels = 0.0;
+        for (const auto& frame : m_frames) pixels += static_cast<double>(frame.paintedPixels);
+        return pixels / static_cast<double>(m_frames.size());
+    }
+
+    // 窗口内第一帧开始到最后一帧结束之间平均每秒重绘的像素数
+    [[nodiscard]] double paintedPixelsPerSecond() const {
+        if (m_frames.empty()) return 0.0;
+        const double spanUs = m_frames.back().startUs + m_frames.back().totalUs - m_frames.front().startUs;
+        if (spanUs <= 0.0) return 0.0;
+        return paintedPixelsPerFrame() * static_cast<double>(m_frames.size()) / (spanUs / 1.0e6);
+    }
+
+    // 窗口内丢弃的帧数
+    [[nodiscard]] std::uint64_t droppedFrames() const {
+        std::uint64_t dropped = 0;
+        for (const auto& frame : m_frames) dropped += frame.droppedFrames;
+        return dropped;
+    }
+
+    // 只统计执行了该区段的帧；section 为 FrameSection 时统计整帧
+    [[nodiscard]] Summary summary(std::uint32_t section) const {
+        std::vector<double>& samples = collect(section);
+        Summary result;
+        result.samples = samples.size();
+        if (samples.empty()) return result;
+
+        std::ranges::sort(samples);
+        result.p50Us = samples[(samples.size() - 1) / 2];
+        result.p95Us = samples[(samples.size() - 1) * 95 / 100];
+        result.maxUs = samples.back();
+        return result;
+    }
+
+    [[nodiscard]] Histogram histogram(std::uint32_t section) const {
+        Histogram buckets{};
+        for (const double us : collect(section)) {
+            const auto edge = std::ranges::upper_bound(BucketEdgesUs, us);
+            ++buckets[static_cast<std::size_t>(edge - BucketEdgesUs.begin())];
+        }
+        return buckets;
+    }
+
+    // Chrome trace 格式：帧与区段为完整事件（ph = X），update 请求、动画数与重绘像素数为计数器（ph = C）
+    void writeChromeTrace(std::ostream& out) const {
+        out << std::fixed << std::setprecision(3) << "{\"traceEvents\": [\n";
+        bool first = true;
+        const auto separator = [&]() -> std::ostream& {
+            out << (first ? "  " : ",\n  ");
+            first = false;
+            return out;
+        };
+
+        for (const auto& frame : m_frames) {
+            separator() << R"({"name": "frame", "ph": "X", "pid": 1, "tid": 1, "ts": )" << frame.startUs
+                        << ", \"dur\": " << frame.totalUs << ", \"args\": {\"index\": " << frame.index << "}}";
+            separator() << R"({"name": "counters", "ph": "C", "pid": 1, "ts": )" << frame.startUs
+                        << ", \"args\": {\"updateRequests\": " << frame.updateRequests
+                        << ", \"animations\": " << frame.animations
+                        << ", \"paintedPixels\": " << frame.paintedPixels
+                        << ", \"droppedFrames\": " << frame.droppedFrames << "}}";
+            if (frame.inputLatencyUs >= 0.0f) {
+                separator() << R"({"name": "inputLatencyUs", "ph": "C", "pid": 1, "ts": )" << frame.startUs
+                            << ", \"args\": {\"latency\": " << frame.inputLatencyUs << "}}";
+            }
+        }
+        for (const auto& event : m_events) {
+            separator() << "{\"name\": \"" << sectionName(event.section) << R"(", "ph": "X", "pid": 1, "tid": 1, "ts": )"
+                        << event.startUs << ", \"dur\": " << event.durationUs << "}";
+        }
+        out << "\n], \"displayTimeUnit\": \"ms\"}\n";
+    }
+
+    // 每帧一行：frame,start_us,total_us,update_requests,animations,painted_px,input_latency_us,dropped,<各区段>_us（未执行 / 没有输入为空）
+    void writeCsv(std::ostream& out) const {
+        out << std::fixed << std::setprecision(3) << "frame,start_us,total_us,update_requests,animations,painted_px,input_latency_us,dropped";
+        for (const auto& name : m_sectionNames) out << ',' << name << "_us";
+        out << '\n';
+
+        for (const auto& frame : m_frames) {
+            out << frame.index << ',' << frame.startUs << ',' << frame.totalUs << ','
+                << frame.updateRequests << ',' << frame.animations << ',' << frame.paintedPixels << ',';
+            if (frame.inputLatencyUs >= 0.0f) out << frame.inputLatencyUs;
+            out << ',' << frame.droppedFrames;
+            for (std::size_t s = 0; s < m_sectionNames.size(); ++s) {
+                out << ',';
+                if (frame.sectionUs[s] >= 0.0f) out << frame.sectionUs[s];
+            }
+            out << '\n';
+        }
+    }
+
+private:
+    [[nodiscard]] double toUs(Clock::time_point t) const {
+        return std::chrono::duration<double, std::micro>(t - m_epoch).count();
+    }
+
+    void beginFrame() {
+        m_current = FrameRecord{};
+        m_current.index = m_frameCount;
+        m_current.sectionUs.fill(-1.0f);
+        m_frameStart = Clock::now();
+        m_current.startUs = toUs(m_frameStart);
+        m_inFrame = true;
+    }
+
+    void endFrame() {
+        if (!m_inFrame) return;
+        m_current.totalUs = std::chrono::duration<double, std::micro>(Clock::now() - m_frameStart).count();
+        m_current.updateRequests = m_pendingRequests;
+        m_pendingRequests = 0;
+        m_frames.push(m_current);
+        ++m_frameCount;
+        m_inFrame = false;
+    }
+
+    // 同一帧内多次执行的区段累加
+    void record(std::uint32_t section, Clock::time_point start, Clock::time_point end) {
+        const double durationUs = std::chrono::duration<double, std::micro>(end - start).count();
+        m_events.push(Event{section, toUs(start), durationUs});
+
+        if (m_inFrame && section < MaxSections) {
+            float& slot = m_current.sectionUs[section];
+            slot = (slot < 0.0f ? 0.0f : slot) + static_cast<float>(durationUs);
+        }
+    }
+
+    std::vector<double>& collect(std::uint32_t section) const {
+        m_scratch.clear();
+        for (const auto& frame : m_frames) {
+            if (section == FrameSection) {
+                m_scratch.push_back(frame.totalUs);
+            } else if (section == LatencySection) {
+                if (frame.inputLatencyUs >= 0.0f) m_scratch.push_back(frame.inputLatencyUs);
+            } else if (section < MaxSections && frame.sectionUs[section] >= 0.0f) {
+                m_scratch.push_back(frame.sectionUs[section]);
+            }
+        }
+        return m_scratch;
+    }
+
+    bool                        m_enabled = false;
+    bool                        m_inFrame = false;
+
+    std::vector<std::string>    m_sectionNames;
+    RingBuffer<FrameRecord>     m_frames;
+    RingBuffer<Event>           m_events;
+
+    Clock::time_point           m_epoch = Clock::now();
+    Clock::time_point           m_frameStart{};
+    FrameRecord                 m_current{};
+
+    std::uint64_t               m_frameCount         = 0;
+    std::uint32_t               m_pendingRequests    = 0;
+    std::uint64_t               m_totalRequests      = 0;
+    std::uint64_t               m_totalPaintedPixels = 0;
+
+    mutable std::vector<double> m_scratch;
+};
+
+#endif //FRAMEPROFILER_H
@@ -0,0 +1,82 @@
+#ifndef FRAMEPROFILEROVERLAY_H
+#define FRAMEPROFILEROVERLAY_H
+
+#include <QFont>
+#include <QColor>
+#include <QRectF>
+#include <QString>
+#include <QPainter>
+
+#include "FrameProfiler.h"
+
+namespace FrameProfilerOverlay {
+    constexpr qreal Width      = 240.0;
+    constexpr qreal LineHeight = 14.0;
+    constexpr qreal ChartH     = 40.0;
+}
+
+// 面板占用的区域；按区域重绘时调用方需要把它并入每次的重绘区域
+inline QRectF frameProfilerPanelRect(const FrameProfiler& profiler, const QPointF& topLeft) {
+    using namespace FrameProfilerOverlay;
+    const auto lines = static_cast<qreal>(profiler.sectionCount() + 4);
+    return {topLeft, QSizeF(Width, lines * LineHeight + ChartH + 12.0)};
+}
+
+// 在 topLeft 处绘制半透明的统计面板：各区段 p50 / p95、每次绘制的 update() 请求数、存活动画数、
+// 每秒重绘的像素数、输入延迟与丢弃的帧数，以及最近 window 帧整帧耗时的柱状图（红线为 16.7 ms）。面板本身不计入任何区段
+inline void paintFrameProfiler(QPainter& painter, const FrameProfiler& profiler, const QPointF& topLeft) {
+    using namespace FrameProfilerOverlay;
+    constexpr double budgetUs = 16667.0;
+
+    const QRectF panel = frameProfilerPanelRect(profiler, topLeft);
+
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 170));
+    painter.drawRect(panel);
+
+    painter.setFont(QFont("Consolas", 8));
+    painter.setPen(Qt::white);
+
+    const auto ms = [](double us) { return QString::number(us / 1000.0, 'f', 2); };
+
+    qreal y = panel.top() + 4.0;
+    const auto line = [&](const QString& text) {
+        painter.drawText(QRectF(panel.left() + 6.0, y, Width - 12.0, LineHeight), Qt::AlignLeft | Qt::AlignVCenter, text);
+        y += LineHeight;
+    };
+
+    const auto frame = profiler.summary(FrameProfiler::FrameSection);
+    line(QString("frame  p50 %1  p95 %2 ms").arg(ms(frame.p50Us), ms(frame.p95Us)));
+    for (std::uint32_t s = 0; s < profiler.sectionCount(); ++s) {
+        const auto summary = profiler.summary(s);
+        line(QString("%1  %2 / %3").arg(QString::fromStdString(profiler.sectionName(s)), ms(summary.p50Us), ms(summary.p95Us)));
+    }
+
+    const std::uint32_t animations = profiler.frames().empty() ? 0 : profiler.frames().back().animations;
+    line(QString("update/paint %1  anim %2").arg(QString::number(profiler.requestsPerPaint(), 'f', 1)).arg(animations));
+    line(QString("repaint %1 Mpx/s  %2 px/frame").arg(QString::number(profiler.paintedPixelsPerSecond() / 1.0e6, 'f', 2))
+                                                   .arg(profiler.paintedPixelsPerFrame(), 0, 'f', 0));
+    const auto latency = profiler.summary(FrameProfiler::LatencySection);
+    line(QString("input  p50 %1  p95 %2 ms  drop %3").arg(ms(latency.p50Us), ms(latency.p95Us)).arg(profiler.droppedFrames()));
+
+    // 柱高以 2 倍帧预算为满格
+    const QRectF chart(panel.left() + 6.0, y + 2.0, Width - 12.0, ChartH);
+    const auto& frames = profiler.frames();
+    if (!frames.empty()) {
+        const qreal barWidth = chart.width() / static_cast<qreal>(frames.capacity());
+        for (std::size_t i = 0; i < frames.size(); ++i) {
+            const double ratio = std::min(frames[i].totalUs / (2.0 * budgetUs), 1.0);
+            const qreal h = chart.height() * ratio;
+            painter.fillRect(QRectF(chart.left() + barWidth * i, chart.bottom() - h, std::max<qreal>(barWidth, 1.0), h),
+                             frames[i].totalUs > budgetUs ? QColor(255, 120, 80) : QColor(120, 220, 140));
+        }
+    }
+    painter.setPen(QColor(255, 60, 60));
+    painter.drawLine(QPointF(chart.left(), chart.center().y()), QPointF(chart.right(), chart.center().y()));
+
+    painter.restore();
+}
+
+#endif //FRAMEPROFILEROVERLAY_H
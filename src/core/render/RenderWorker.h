@@ -0,0 +1,168 @@
+#ifndef RENDERWORKER_H
+#define RENDERWORKER_H
+
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <condition_variable>
+
+#include <QSize>
+#include <QImage>
+#include <QRegion>
+#include <QPainter>
+
+// 后台绘制线程：GUI 线程提交不可变的帧快照，工作线程把它绘制到离屏 QImage，GUI 线程的 paintEvent 只贴图。
+//
+// 快照邮箱只保存最新的一帧，工作线程忙时到达的新快照覆盖尚未开始绘制的旧快照（计为丢弃，区域并入新快照）。
+// 图像双缓冲：工作线程独占后缓冲，绘制完成后在锁内与前缓冲交换；GUI 线程只在锁内读取前缓冲，
+// 所以贴图期间工作线程可以继续绘制下一帧，只在交换时等待。绘制完成但在下一帧完成前没有被呈现的帧同样计为丢弃。
+//
+// 两个缓冲交替使用，后缓冲缺少的是上一帧画进另一个缓冲的区域，所以每帧重绘 本帧区域 ∪ 上一帧区域；尺寸或 dpr 变化时整帧重绘。
+//
+// Frame_ 需要可复制，并提供 size (QSize)、dpr (qreal)、region (QRegion，绘制时被替换为实际重绘的区域)。
+template <typename Frame_>
+class RenderWorker {
+public:
+    // 在工作线程调用：painter 已裁剪到 frame.region 并清除为透明
+    using Render = std::function<void(QPainter&, const Frame_&)>;
+    // 在工作线程调用：一帧绘制完成并成为前缓冲，frame 的 region 为该帧提交时的区域
+    using Ready  = std::function<void(const Frame_&)>;
+
+    struct Stats {
+        std::uint64_t submitted       = 0;
+        std::uint64_t rendered        = 0;
+        std::uint64_t presented       = 0;
+        std::uint64_t droppedQueued   = 0;   // 开始绘制前被更新的快照覆盖
+        std::uint64_t droppedRendered = 0;   // 绘制完成但没有被呈现
+
+        [[nodiscard]] auto dropped() const -> std::uint64_t { return droppedQueued + droppedRendered; }
+    };
+
+    RenderWorker(Render render, Ready ready)
+        : m_render(std::move(render)), m_ready(std::move(ready)), m_thread([this]() { run(); }) {}
+
+    ~RenderWorker() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    RenderWorker(const RenderWorker&) = delete;
+    RenderWorker& operator=(const RenderWorker&) = delete;
+
+    // 复制到邮箱（复用邮箱内已有的内存）。覆盖尚未绘制的快照时，它的区域并入新快照：
+    // 提交方已经清空了这部分待重绘区域，丢掉它会让两个缓冲在该区域都保留旧内容
+    void submit(const Frame_& frame) {
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_pending) {
+                ++m_stats.droppedQueued;
+                const QRegion dropped = std::move(m_mailbox.region);
+                m_mailbox = frame;
+                m_mailbox.region = m_mailbox.region.united(dropped);
+            } else {
+                m_mailbox = frame;
+            }
+            m_pending = true;
+            ++m_stats.submitted;
+        }
+        m_wake.notify_one();
+    }
+
+    // 在锁内以 (前缓冲, 该帧快照) 调用 present，还没有完成任何一帧时返回 false。
+    // 同一帧可以多次呈现（例如窗口被遮挡后重新露出），只有第一次计入 presented
+    template <typename Present_>
+    bool present(Present_&& present) {
+        std::lock_guard lock(m_mutex);
+        if (m_front.isNull()) return false;
+
+        present(std::as_const(m_front), std::as_const(m_frontFrame), m_unpresented);
+        if (m_unpresented) ++m_stats.presented;
+        m_unpresented = false;
+        return true;
+    }
+
+    [[nodiscard]] Stats stats() const {
+        std::lock_guard lock(m_mutex);
+        return m_stats;
+    }
+
+private:
+    void run() {
+        QRegion previous;   // 上一帧提交时的区域，即当前后缓冲缺少的部分
+
+        for (;;) {
+            {
+                std::unique_lock lock(m_mutex);
+                m_wake.wait(lock, [this]() { return m_stop || m_pending; });
+                if (m_stop) return;
+
+                std::swap(m_working, m_mailbox);
+                m_pending = false;
+            }
+
+            const QRegion submitted = m_working.region;
+            const QSize pixels(static_cast<int>(std::ceil(m_working.size.width() * m_working.dpr)),
+                               static_cast<int>(std::ceil(m_working.size.height() * m_working.dpr)));
+
+            if (m_back.size() != pixels || m_back.devicePixelRatio() != m_working.dpr) {
+                m_back = QImage(pixels, QImage::Format_ARGB32_Premultiplied);
+                m_back.setDevicePixelRatio(m_working.dpr);
+                m_working.region = QRegion(QRect(QPoint(), m_working.size));
+            } else {
+                m_working.region = submitted.united(previous);
+            }
+
+            {
+                QPainter painter(&m_back);
+                painter.setClipRegion(m_working.region);
+                painter.setCompositionMode(QPainter::CompositionMode_Source);
+                for (const QRect& r : m_working.region) painter.fillRect(r, Qt::transparent);
+                painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+                painter.setRenderHint(QPainter::Antialiasing);
+                m_render(painter, m_working);
+            }
+
+            m_working.region = submitted;
+            previous = submitted;
+
+            {
+                std::lock_guard lock(m_mutex);
+                std::swap(m_back, m_front);
+                std::swap(m_working, m_frontFrame);
+                if (m_unpresented) ++m_stats.droppedRendered;
+                m_unpresented = true;
+                ++m_stats.rendered;
+            }
+
+            // m_frontFrame 只在本线程中被替换，这里读取不需要加锁
+            m_ready(m_frontFrame);
+        }
+    }
+
+    Render                      m_render;
+    Ready                       m_ready;
+
+    mutable std::mutex          m_mutex;
+    std::condition_variable     m_wake;
+    bool                        m_stop        = false;
+    bool                        m_pending     = false;
+    bool                        m_unpresented = false;
+
+    Frame_                      m_mailbox{};
+    Frame_                      m_working{};      // 工作线程独占
+    Frame_                      m_frontFrame{};   // 前缓冲对应的快照
+    QImage                      m_back;           // 工作线程独占
+    QImage                      m_front;
+    Stats                       m_stats;
+
+    std::thread                 m_thread;         // 最后构造：线程启动时其余成员已经初始化
+};
+
+#endif //RENDERWORKER_H
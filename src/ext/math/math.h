@@ -45,4 +45,7 @@ namespace Keruis::Math {
             return (dx * dx + dy * dy) < dst * dst;
         }
     }
-}
\ No newline at end of file
+}
+
+#include "approx.h"
+#include "vec2.h"
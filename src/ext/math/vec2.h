@@ -0,0 +1,284 @@
+#pragma once
+
+#include <span>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <concepts>
+#include <type_traits>
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define KERUIS_MATH_SIMD 1
+#else
+#define KERUIS_MATH_SIMD 0
+#endif
+
+#include "approx.h"
+
+// 二维向量与 SoA 批量运算。
+// Vec2 为两个紧凑的 float（8 字节，无填充）；Vec2Span 为 x / y 分列连续的视图，批量函数按 SIMD 宽度成组处理，
+// 剩余不足一组的元素走标量路径，两条路径使用相同的公式（未启用 FMA 收缩时结果逐位一致）。<experimental/simd> 不可用时全部走标量路径。
+namespace Keruis::Math {
+
+    // 具有 x() / y() 访问器且可由 (x, y) 构造的点类型，如 QPointF
+    template <typename Ty_>
+    concept PointLike = requires(const Ty_& p, double x, double y) {
+        { p.x() } -> std::convertible_to<double>;
+        { p.y() } -> std::convertible_to<double>;
+        { Ty_(x, y) };
+    };
+
+    struct Vec2 {
+        float x = 0.0f;
+        float y = 0.0f;
+
+        constexpr Vec2() noexcept = default;
+        constexpr Vec2(const float x, const float y) noexcept : x(x), y(y) {}
+
+        // 从 QPointF 等 double 坐标的点类型转换会把坐标截断为 float（约 7 位有效数字，±4096 以内误差不超过 2.5e-4），
+        // 所以不提供隐式转换，需要写成 Vec2::from(p)
+        template <PointLike Ty_>
+        constexpr explicit Vec2(const Ty_& p) noexcept : x(static_cast<float>(p.x())), y(static_cast<float>(p.y())) {}
+
+        template <PointLike Ty_>
+        [[nodiscard]] static constexpr Vec2 from(const Ty_& p) noexcept { return Vec2(p); }
+
+        template <PointLike Ty_>
+        [[nodiscard]] constexpr Ty_ to() const noexcept { return Ty_(x, y); }
+
+        constexpr Vec2  operator+ (const Vec2 o)  const noexcept { return {x + o.x, y + o.y}; }
+        constexpr Vec2  operator- (const Vec2 o)  const noexcept { return {x - o.x, y - o.y}; }
+        constexpr Vec2  operator* (const float s) const noexcept { return {x * s, y * s};     }
+        constexpr Vec2  operator- ()              const noexcept { return {-x, -y};           }
+        constexpr Vec2& operator+=(const Vec2 o)        noexcept { x += o.x; y += o.y; return *this; }
+        constexpr Vec2& operator-=(const Vec2 o)        noexcept { x -= o.x; y -= o.y; return *this; }
+        constexpr bool  operator==(const Vec2&)   const noexcept = default;
+
+        [[nodiscard]] constexpr float dot(const Vec2 o)     const noexcept { return x * o.x + y * o.y; }
+        [[nodiscard]] constexpr float lengthSquared()       const noexcept { return x * x + y * y;     }
+        [[nodiscard]] float           length()              const noexcept { return std::sqrt(lengthSquared()); }
+
+        // a + t * (b - a)，与批量版本的 lerp 结果一致
+        [[nodiscard]] static constexpr Vec2 lerp(const Vec2 a, const Vec2 b, const float t) noexcept {
+            return {a.x + t * (b.x - a.x), a.y + t * (b.y - a.y)};
+        }
+
+        [[nodiscard]] static float distance(const Vec2 a, const Vec2 b) noexcept {
+            return (b - a).length();
+        }
+    };
+
+    static_assert(sizeof(Vec2) == 2 * sizeof(float));
+
+    // x / y 两列的视图，两列长度相同。Fp 为 float 或 const float
+    template <typename Fp>
+    class BasicVec2Span {
+    public:
+        constexpr BasicVec2Span() noexcept = default;
+        constexpr BasicVec2Span(Fp* x, Fp* y, const std::size_t size) noexcept : m_x(x, size), m_y(y, size) {}
+        constexpr BasicVec2Span(std::span<Fp> x, std::span<Fp> y) noexcept : m_x(x), m_y(y.first(x.size())) {}
+
+        // Vec2Span -> ConstVec2Span
+        template <typename Other_>
+        requires std::same_as<const Other_, Fp> && (!std::same_as<Other_, Fp>)
+        constexpr BasicVec2Span(const BasicVec2Span<Other_>& other) noexcept : m_x(other.x()), m_y(other.y()) {}
+
+        [[nodiscard]] constexpr auto size()  const noexcept -> std::size_t { return m_x.size();  }
+        [[nodiscard]] constexpr bool empty() const noexcept                { return m_x.empty(); }
+
+        [[nodiscard]] constexpr auto x() const noexcept -> std::span<Fp> { return m_x; }
+        [[nodiscard]] constexpr auto y() const noexcept -> std::span<Fp> { return m_y; }
+
+        [[nodiscard]] constexpr Vec2 operator[](const std::size_t i) const noexcept { return {m_x[i], m_y[i]}; }
+
+        constexpr void set(const std::size_t i, const Vec2 v) const noexcept requires (!std::is_const_v<Fp>) {
+            m_x[i] = v.x;
+            m_y[i] = v.y;
+        }
+
+        [[nodiscard]] constexpr BasicVec2Span subspan(const std::size_t offset, const std::size_t count) const noexcept {
+            return {m_x.subspan(offset, count), m_y.subspan(offset, count)};
+        }
+
+    private:
+        std::span<Fp> m_x;
+        std::span<Fp> m_y;
+    };
+
+    using Vec2Span      = BasicVec2Span<float>;
+    using ConstVec2Span = BasicVec2Span<const float>;
+
+    // 持有存储的 SoA 数组，用于需要长期保存批量结果的场合
+    class Vec2Buffer {
+    public:
+        Vec2Buffer() = default;
+        explicit Vec2Buffer(const std::size_t size) : m_x(size), m_y(size) {}
+
+        [[nodiscard]] auto size()  const -> std::size_t { return m_x.size();  }
+        [[nodiscard]] bool empty() const                { return m_x.empty(); }
+
+        void resize(const std::size_t size) { m_x.resize(size); m_y.resize(size); }
+        void clear()                        { m_x.clear();      m_y.clear();      }
+        void push_back(const Vec2 v)        { m_x.push_back(v.x); m_y.push_back(v.y); }
+
+        [[nodiscard]] Vec2 operator[](const std::size_t i) const { return {m_x[i], m_y[i]}; }
+
+        [[nodiscard]] Vec2Span      span()       { return {m_x.data(), m_y.data(), m_x.size()}; }
+        [[nodiscard]] ConstVec2Span span() const { return {m_x.data(), m_y.data(), m_x.size()}; }
+
+        operator Vec2Span()            { return span(); }
+        operator ConstVec2Span() const { return span(); }
+
+    private:
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+    };
+
+    namespace Detail {
+
+#if KERUIS_MATH_SIMD
+        namespace stdx = std::experimental;
+
+        using FloatV = stdx::native_simd<float>;
+        using ByteV  = stdx::rebind_simd_t<std::uint8_t, FloatV>;
+        inline constexpr std::size_t Lanes = FloatV::size();
+
+        inline FloatV load(const float* p)          { return FloatV(p, stdx::element_aligned); }
+        inline void   store(const FloatV v, float* p) { v.copy_to(p, stdx::element_aligned);   }
+
+        template <std::size_t N>
+        inline FloatV horner(const double (&c)[N], const FloatV x2) {
+            FloatV s(static_cast<float>(c[N - 1]));
+            for (std::size_t i = N - 1; i-- > 0;) {
+                s = s * x2 + FloatV(static_cast<float>(c[i]));
+            }
+            return s;
+        }
+
+        template <Precision P>
+        constexpr decltype(auto) sin_coeff() {
+            if constexpr (P == Precision::Low)         return (Coeff::SinLow);
+            else if constexpr (P == Precision::Medium) return (Coeff::SinMedium);
+            else                                       return (Coeff::SinHigh);
+        }
+
+        // 与标量 fast_sin / fast_cos 相同的约减与折叠
+        template <Precision P>
+        inline void sincos(const FloatV x, FloatV& s, FloatV& c) {
+            const FloatV k = stdx::round(x * static_cast<float>(1.0 / Coeff::TwoPi));
+            const FloatV r = ((x - k * static_cast<float>(Coeff::TwoPiHi)) - k * static_cast<float>(Coeff::TwoPiMid))
+                             - k * static_cast<float>(Coeff::TwoPiLo);
+
+            constexpr float pi     = static_cast<float>(Coeff::Pi);
+            constexpr float halfPi = static_cast<float>(Coeff::HalfPi);
+
+            FloatV rs = r;
+            stdx::where(r > halfPi, rs)  = pi - r;
+            stdx::where(r < -halfPi, rs) = -pi - r;
+            s = rs * horner(sin_coeff<P>(), rs * rs);
+
+            const FloatV rc = halfPi - stdx::abs(r);
+            c = rc * horner(sin_coeff<P>(), rc * rc);
+        }
+#else
+        inline constexpr std::size_t Lanes = 1;
+#endif
+
+    }
+
+    // ======= 批量版本：输出的长度须不小于输入，多个输入时以第一个输入的长度为准 =======
+
+    // out[i] = a[i] + t * (b[i] - a[i])，out 可以与 a 或 b 相同
+    MATH_BATCH_ATTR inline void lerp(const ConstVec2Span a, const ConstVec2Span b, const float t, const Vec2Span out) noexcept {
+        const std::size_t n = a.size();
+        std::size_t i = 0;
+#if KERUIS_MATH_SIMD
+        using namespace Detail;
+        for (; i + Lanes <= n; i += Lanes) {
+            const FloatV ax = load(&a.x()[i]);
+            const FloatV ay = load(&a.y()[i]);
+            store(ax + t * (load(&b.x()[i]) - ax), &out.x()[i]);
+            store(ay + t * (load(&b.y()[i]) - ay), &out.y()[i]);
+        }
+#endif
+        for (; i < n; ++i) out.set(i, Vec2::lerp(a[i], b[i], t));
+    }
+
+    // out[i] = |b[i] - a[i]|
+    MATH_BATCH_ATTR inline void distance(const ConstVec2Span a, const ConstVec2Span b, const std::span<float> out) noexcept {
+        const std::size_t n = a.size();
+        std::size_t i = 0;
+#if KERUIS_MATH_SIMD
+        using namespace Detail;
+        for (; i + Lanes <= n; i += Lanes) {
+            const FloatV dx = load(&b.x()[i]) - load(&a.x()[i]);
+            const FloatV dy = load(&b.y()[i]) - load(&a.y()[i]);
+            store(stdx::sqrt(dx * dx + dy * dy), &out[i]);
+        }
+#endif
+        for (; i < n; ++i) out[i] = Vec2::distance(a[i], b[i]);
+    }
+
+    // out[i] = |p - a[i]|，命中测试用
+    MATH_BATCH_ATTR inline void distance(const ConstVec2Span a, const Vec2 p, const std::span<float> out) noexcept {
+        const std::size_t n = a.size();
+        std::size_t i = 0;
+#if KERUIS_MATH_SIMD
+        using namespace Detail;
+        for (; i + Lanes <= n; i += Lanes) {
+            const FloatV dx = p.x - load(&a.x()[i]);
+            const FloatV dy = p.y - load(&a.y()[i]);
+            store(stdx::sqrt(dx * dx + dy * dy), &out[i]);
+        }
+#endif
+        for (; i < n; ++i) out[i] = Vec2::distance(a[i], p);
+    }
+
+    // out[i] = |p - a[i]| < dst（与标量 equals 相同的严格小于），返回命中的数量
+    MATH_BATCH_ATTR inline std::size_t equals(const ConstVec2Span a, const Vec2 p, const float dst, const std::span<std::uint8_t> out) noexcept {
+        const std::size_t n = a.size();
+        const float dst2 = dst * dst;
+        std::size_t hits = 0;
+        std::size_t i = 0;
+#if KERUIS_MATH_SIMD
+        using namespace Detail;
+        for (; i + Lanes <= n; i += Lanes) {
+            const FloatV dx = p.x - load(&a.x()[i]);
+            const FloatV dy = p.y - load(&a.y()[i]);
+            const auto mask = (dx * dx + dy * dy) < dst2;
+            // 掩码转成 0 / 1 后整组写出，逐个通道写入时编译器不会向量化
+            FloatV hit(0.0f);
+            stdx::where(mask, hit) = 1.0f;
+            stdx::static_simd_cast<ByteV>(hit).copy_to(&out[i], stdx::element_aligned);
+            hits += static_cast<std::size_t>(stdx::popcount(mask));
+        }
+#endif
+        for (; i < n; ++i) {
+            const bool hit = (p - a[i]).lengthSquared() < dst2;
+            out[i] = hit;
+            hits += hit;
+        }
+        return hits;
+    }
+
+    // out[i] = (cos(angle[i]) * length[i], sin(angle[i]) * length[i])，三角函数使用 fast_sin / fast_cos 的 P 档位
+    template <Precision P = Precision::High>
+    MATH_BATCH_ATTR inline void from_polar_rad(const std::span<const float> angle, const std::span<const float> length, const Vec2Span out) noexcept {
+        const std::size_t n = angle.size();
+        std::size_t i = 0;
+#if KERUIS_MATH_SIMD
+        using namespace Detail;
+        for (; i + Lanes <= n; i += Lanes) {
+            FloatV s, c;
+            Detail::sincos<P>(load(&angle[i]), s, c);
+            const FloatV len = load(&length[i]);
+            store(c * len, &out.x()[i]);
+            store(s * len, &out.y()[i]);
+        }
+#endif
+        for (; i < n; ++i) out.set(i, {fast_cos<P>(angle[i]) * length[i], fast_sin<P>(angle[i]) * length[i]});
+    }
+
+}
@@ -0,0 +1,103 @@
+// 损坏的编译菜单不导致越界访问：标签偏移表首尾与字符段不一致的文件不被映射；
+// 节点的子节点区间或标签 Id 越界时，MenuTree 按无子节点 / 空标签处理，搜索索引照常建立。
+// 失败时打印原因并返回 1（ctest 以退出码判定）
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+
+#include <QDir>
+#include <QFile>
+#include <QByteArray>
+
+#include "../src/core/menu/MenuFile.h"
+#include "../src/core/menu/MenuSearch.h"
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (condition) return;
+        ++failures;
+        std::fprintf(stderr, "FAIL %s\n", what);
+    }
+
+    bool write(const QString& path, const QByteArray& bytes) {
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(bytes) == bytes.size();
+    }
+
+    // 把 bytes 中第 index 个标签偏移改为 value
+    QByteArray withOffset(QByteArray bytes, std::uint32_t index, std::uint32_t value) {
+        MenuFile::Header header;
+        std::memcpy(&header, bytes.constData(), sizeof(header));
+        const std::size_t at = sizeof(MenuFile::Header) + header.nodeCount * sizeof(MenuTree::Node) + index * sizeof(std::uint32_t);
+        std::memcpy(bytes.data() + at, &value, sizeof(value));
+        return bytes;
+    }
+
+    void checkMap() {
+        MenuTree tree;
+        if (!MenuFile::parse("Apps\n    Terminal\n    Browser\nFiles\n", tree)) {
+            check(false, "parse");
+            return;
+        }
+        const QByteArray bytes = MenuFile::compile(tree);
+        MenuFile::Header header;
+        std::memcpy(&header, bytes.constData(), sizeof(header));
+
+        const QString path = QDir::temp().filePath(QStringLiteral("KeruisUtilsMenuFileTest.kmenu"));
+
+        check(write(path, bytes) && MenuFile::map(path) != nullptr, "intact file is mapped");
+        check(write(path, withOffset(bytes, 0, 1)) && MenuFile::map(path) == nullptr,
+              "file whose first label offset is not 0 is rejected");
+        check(write(path, withOffset(bytes, header.labelCount, header.labelBytes - 1)) && MenuFile::map(path) == nullptr,
+              "file whose last label offset is not labelBytes is rejected");
+
+        QFile::remove(path);
+    }
+
+    // 根有 3 个子节点；节点 1 的标签 Id 与子节点区间越界，节点 2 的子节点区间超出节点数组
+    void checkCorruptNodes() {
+        static MenuTree::Node nodes[4] = {};
+        nodes[0].firstChild = 1;
+        nodes[0].childCount = 3;
+        nodes[1].label = 99;
+        nodes[1].firstChild = 2;
+        nodes[1].childCount = 0xFFFFFFFFu;
+        nodes[2].label = 1;
+        nodes[2].firstChild = 3;
+        nodes[2].childCount = 5;
+        nodes[3].label = 2;
+
+        static const std::uint32_t offsets[] = {0, 0, 3, 6};
+        static const char chars[] = "appbox";
+        const MenuTree::Labels labels{std::span(offsets), std::span(chars, 6)};
+        const auto tree = std::make_shared<const MenuTree>(std::span<const MenuTree::Node>(nodes), labels, nullptr);
+
+        check(tree->children(1).empty(), "child range past the end is empty");
+        check(tree->children(2).empty(), "child range overflowing the node array is empty");
+        check(tree->child(2, 0) == MenuTree::Root, "child of an out-of-range range is Root");
+        check(tree->label(1).empty() && tree->labelId(1) == 0, "out-of-range label id reads as the empty label");
+        check(tree->label(2) == "app", "valid label");
+
+        MenuSearch search(tree);
+        const auto results = search.search("box", 8);
+        check(results.size() == 1 && results[0] == 3, "search over a corrupt tree finds the valid node");
+    }
+
+}
+
+int main() {
+    checkMap();
+    checkCorruptNodes();
+
+    if (failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("MenuFile: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,129 @@
+// RenderWorker 丢弃排队快照时不丢失其重绘区域：悬停高亮被移除的那一帧在工作线程忙时被下一帧覆盖，
+// 最终呈现的缓冲中高亮必须已被清除（两个缓冲交替使用，丢失区域会让另一个缓冲保留旧的高亮）。
+// 失败时打印原因并返回 1（ctest 以退出码判定）
+
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <condition_variable>
+
+#include <QRect>
+#include <QSize>
+#include <QColor>
+#include <QImage>
+#include <QRegion>
+#include <QPainter>
+
+#include "../src/core/render/RenderWorker.h"
+
+namespace {
+
+    int failures = 0;
+
+    constexpr QSize WindowSize(64, 64);
+    const QRect Highlight(8, 8, 16, 16);    // 悬停高亮
+    const QRect Trail(40, 40, 8, 8);        // 与高亮无关的另一处变化
+
+    struct Frame {
+        QSize   size;
+        qreal   dpr = 1.0;
+        QRegion region;
+        int     id = 0;
+        bool    highlight = false;
+    };
+
+    Frame frame(int id, bool highlight, const QRegion& region) {
+        Frame f;
+        f.size = WindowSize;
+        f.region = region;
+        f.id = id;
+        f.highlight = highlight;
+        return f;
+    }
+
+    // 工作线程在绘制 BlockId 时等待放行，期间提交的快照在邮箱中排队
+    constexpr int BlockId = 3;
+
+    std::mutex              mutex;
+    std::condition_variable changed;
+    bool                    blocked  = false;
+    bool                    released = false;
+    int                     readyId  = 0;
+
+    template <typename Predicate_>
+    bool waitFor(Predicate_ predicate) {
+        std::unique_lock lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(5), predicate);
+    }
+
+    void render(QPainter& painter, const Frame& f) {
+        if (f.id == BlockId) {
+            std::unique_lock lock(mutex);
+            blocked = true;
+            changed.notify_all();
+            changed.wait(lock, []() { return released; });
+        }
+        painter.fillRect(QRect(QPoint(), f.size), Qt::white);
+        if (f.highlight) painter.fillRect(Highlight, Qt::red);
+    }
+
+    void ready(const Frame& f) {
+        std::lock_guard lock(mutex);
+        readyId = f.id;
+        changed.notify_all();
+    }
+
+}
+
+int main() {
+    {
+        RenderWorker<Frame> worker(render, ready);
+
+        // 1、2：高亮显示，两个缓冲都画上高亮
+        worker.submit(frame(1, true, QRegion(QRect(QPoint(), WindowSize))));
+        if (!waitFor([]() { return readyId == 1; })) { std::fprintf(stderr, "FAIL frame 1 not rendered\n"); return 1; }
+        worker.submit(frame(2, true, QRegion(Trail)));
+        if (!waitFor([]() { return readyId == 2; })) { std::fprintf(stderr, "FAIL frame 2 not rendered\n"); return 1; }
+
+        // 3 绘制中：4（移除高亮）被 5（只有拖尾变化）覆盖
+        worker.submit(frame(BlockId, true, QRegion(Trail)));
+        if (!waitFor([]() { return blocked; })) { std::fprintf(stderr, "FAIL frame 3 not started\n"); return 1; }
+        worker.submit(frame(4, false, QRegion(Highlight)));
+        worker.submit(frame(5, false, QRegion(Trail)));
+        {
+            std::lock_guard lock(mutex);
+            released = true;
+        }
+        changed.notify_all();
+        if (!waitFor([]() { return readyId == 5; })) { std::fprintf(stderr, "FAIL frame 5 not rendered\n"); return 1; }
+
+        if (worker.stats().droppedQueued != 1) {
+            ++failures;
+            std::fprintf(stderr, "FAIL expected 1 dropped queued frame, got %llu\n",
+                         static_cast<unsigned long long>(worker.stats().droppedQueued));
+        }
+
+        worker.present([](const QImage& image, const Frame& f, bool) {
+            if (f.id != 5) {
+                ++failures;
+                std::fprintf(stderr, "FAIL front buffer holds frame %d, expected 5\n", f.id);
+            }
+            if (!f.region.contains(Highlight)) {
+                ++failures;
+                std::fprintf(stderr, "FAIL region of frame 5 does not include the dropped frame's region\n");
+            }
+            const QColor pixel = image.pixelColor(Highlight.center());
+            if (pixel != QColor(Qt::white)) {
+                ++failures;
+                std::fprintf(stderr, "FAIL stale highlight in the front buffer: pixel %s\n", qPrintable(pixel.name(QColor::HexArgb)));
+            }
+        });
+    }
+
+    if (failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("RenderWorker: all checks passed\n");
+    return 0;
+}
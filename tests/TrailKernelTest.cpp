@@ -0,0 +1,161 @@
+// TrailKernel 的 SIMD 实现与标量实现的一致性：对 CPU 支持的每个指令集（通过 setIsa 选择），
+// 角度偏差不超过 AngleTolerance，长度 / 方向 / 偏移量不超过 OffsetTolerance * max(1, |标量结果|)。
+// 失败时打印第一处超差并返回 1（ctest 以退出码判定）
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#include "../src/core/draw/Trail/TrailKernel.h"
+
+namespace {
+
+    using namespace Keruis::Trail;
+
+    constexpr float Pi = 3.14159265358979323846f;
+
+    int failures = 0;
+
+    const char* name(KernelIsa isa) {
+        switch (isa) {
+            case KernelIsa::Scalar: return "Scalar";
+            case KernelIsa::SSE2:   return "SSE2";
+            case KernelIsa::AVX2:   return "AVX2";
+        }
+        return "?";
+    }
+
+    // 一组输入及其输出缓冲
+    struct Trail {
+        std::vector<float> x, y, scale;
+        std::vector<float> length, angle, dirX, dirY, startX, startY, endX, endY;
+
+        explicit Trail(std::size_t count) : x(count), y(count), scale(count) {
+            for (auto* v : {&length, &angle, &dirX, &dirY, &startX, &startY, &endX, &endY}) v->assign(count, 0.0f);
+        }
+
+        [[nodiscard]] SegmentInput input(float radius, float firstProgress, float startAngle) const {
+            return {x.data(), y.data(), scale.data(), x.size(), radius, static_cast<float>(x.size() - 1), firstProgress, startAngle};
+        }
+
+        [[nodiscard]] SegmentOutput output() {
+            return {length.data(), angle.data(), dirX.data(), dirY.data(), startX.data(), startY.data(), endX.data(), endY.data()};
+        }
+    };
+
+    // 随机折线，含零长度、轴向、±0 与 ±4096 附近的线段，以及 scale 为 0 的节点
+    Trail makeTrail(std::size_t count, std::mt19937& rng) {
+        std::uniform_real_distribution<float> step(-60.0f, 60.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::uniform_int_distribution<int> kind(0, 9);
+
+        Trail trail(count);
+        float x = 0.0f, y = 0.0f;
+        for (std::size_t i = 0; i < count; ++i) {
+            switch (kind(rng)) {
+                case 0:  break;                                       // 与上一个节点重合
+                case 1:  x += step(rng); break;                       // 水平
+                case 2:  y += step(rng); break;                       // 垂直
+                case 3:  x += 1e-3f * step(rng); y += 1e-3f * step(rng); break;
+                case 4:  x = (unit(rng) < 0.5f ? -4096.0f : 4096.0f) - step(rng); y = step(rng); break;
+                case 5:  x = -0.0f; y = 0.0f; break;
+                default: x += step(rng); y += step(rng); break;
+            }
+            trail.x[i] = x;
+            trail.y[i] = y;
+            trail.scale[i] = unit(rng) < 0.1f ? 0.0f : unit(rng);
+        }
+        return trail;
+    }
+
+    bool within(float actual, float expected) {
+        return std::fabs(actual - expected) <= OffsetTolerance * std::max(1.0f, std::fabs(expected));
+    }
+
+    // 角度在 ±π 处等价
+    bool withinAngle(float actual, float expected) {
+        float d = std::fabs(actual - expected);
+        d = std::min(d, 2.0f * Pi - d);
+        return d <= AngleTolerance;
+    }
+
+    void compare(const char* what, KernelIsa isa, std::size_t count, const std::vector<float>& actual, const std::vector<float>& expected,
+                 std::size_t segments, bool angle = false) {
+        for (std::size_t k = 0; k < segments; ++k) {
+            if (angle ? withinAngle(actual[k], expected[k]) : within(actual[k], expected[k])) continue;
+            ++failures;
+            std::fprintf(stderr, "FAIL %s %s: count %zu, segment %zu: %.9g vs scalar %.9g\n", name(isa), what, count, k,
+                         static_cast<double>(actual[k]), static_cast<double>(expected[k]));
+            return;
+        }
+    }
+
+    void checkIsa(KernelIsa isa) {
+        setIsa(isa);
+        if (activeIsa() != isa) {
+            ++failures;
+            std::fprintf(stderr, "FAIL setIsa(%s) selected %s\n", name(isa), name(activeIsa()));
+            return;
+        }
+
+        std::mt19937 rng(20240101);
+        std::uniform_real_distribution<float> angles(-Pi, Pi);
+
+        // 覆盖 SIMD 主循环与各种长度的尾部
+        for (std::size_t count = 2; count <= 130; ++count) {
+            for (int round = 0; round < 4; ++round) {
+                Trail trail = makeTrail(count, rng);
+                Trail scalar = trail;
+                const float radius = round == 0 ? 1.0f : 40.0f;
+                const float firstProgress = round == 3 ? 0.37f : 1.0f;
+                const SegmentInput in = trail.input(radius, firstProgress, angles(rng));
+
+                computeSegments(in, trail.output());
+                computeSegments(in, scalar.output(), KernelIsa::Scalar);
+
+                const std::size_t segments = count - 1;
+                compare("length", isa, count, trail.length, scalar.length, segments);
+                compare("angle",  isa, count, trail.angle,  scalar.angle,  segments, true);
+                compare("dirX",   isa, count, trail.dirX,   scalar.dirX,   segments);
+                compare("dirY",   isa, count, trail.dirY,   scalar.dirY,   segments);
+                compare("startX", isa, count, trail.startX, scalar.startX, segments);
+                compare("startY", isa, count, trail.startY, scalar.startY, segments);
+                compare("endX",   isa, count, trail.endX,   scalar.endX,   segments);
+                compare("endY",   isa, count, trail.endY,   scalar.endY,   segments);
+
+                // 只计算偏移（TrailPath 每帧的路径）：方向取自标量结果
+                Trail offsets = scalar;
+                computeOffsets(in, {scalar.length.data(), scalar.dirX.data(), scalar.dirY.data()},
+                               {offsets.startX.data(), offsets.startY.data(), offsets.endX.data(), offsets.endY.data()});
+                compare("computeOffsets startX", isa, count, offsets.startX, scalar.startX, segments);
+                compare("computeOffsets startY", isa, count, offsets.startY, scalar.startY, segments);
+                compare("computeOffsets endX",   isa, count, offsets.endX,   scalar.endX,   segments);
+                compare("computeOffsets endY",   isa, count, offsets.endY,   scalar.endY,   segments);
+            }
+        }
+    }
+
+}
+
+int main() {
+    const KernelIsa supported = detectIsa();
+    for (const KernelIsa isa : {KernelIsa::SSE2, KernelIsa::AVX2}) {
+        if (isa > supported) {
+            std::printf("TrailKernel: %s not supported by this CPU, skipped\n", name(isa));
+            continue;
+        }
+        checkIsa(isa);
+        std::printf("TrailKernel: %s checked\n", name(isa));
+    }
+    setIsa(supported);
+
+    if (failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("TrailKernel: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,145 @@
+// TrailPath 几何缓存的计数检查：每加入一个节点只计算一个线段，绘制（任意 radius / percent）不重新计算；
+// 以及按固定间距重采样的节点位置与输入点的密度无关。
+// 失败时打印原因并返回 1（ctest 以退出码判定）
+
+#include <cmath>
+#include <cstdio>
+#include <chrono>
+#include <cstddef>
+
+#include <QPointF>
+
+#include "../src/core/draw/Trail/TrailPath.h"
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const char* what, std::size_t expected, std::size_t actual) {
+        if (condition) return;
+        ++failures;
+        std::fprintf(stderr, "FAIL %s: expected %zu, got %zu\n", what, expected, actual);
+    }
+
+    void expectEqual(const char* what, std::size_t expected, std::size_t actual) {
+        check(expected == actual, what, expected, actual);
+    }
+
+    QPointF spiral(std::size_t i) {
+        const double angle = static_cast<double>(i) * 0.3;
+        const double radius = 20.0 + 2.0 * static_cast<double>(i);
+        return {380.0 + std::cos(angle) * radius, 380.0 + std::sin(angle) * radius};
+    }
+
+    std::size_t drawnSegments(TrailPath& trail, float radius, float percent) {
+        std::size_t drawn = 0;
+        trail.each(radius, [&drawn](QPointF, QPointF, QPointF, QPointF) { ++drawn; }, percent);
+        return drawn;
+    }
+
+    // 每个新节点恰好计算一个线段，包括容量已满、最旧节点被淘汰之后
+    void pushComputesOneSegment(TrailPath::Storage storage) {
+        constexpr std::size_t Capacity = 32;
+        TrailPath trail(Capacity, storage);
+
+        trail.addPoint(spiral(0));
+        expectEqual("first node computes nothing", 0, trail.stats().computedSegments);
+
+        for (std::size_t i = 1; i < Capacity * 3; ++i) {
+            const std::size_t before = trail.stats().computedSegments;
+            trail.addPoint(spiral(i));
+            expectEqual("segments computed per pushed node", 1, trail.stats().computedSegments - before);
+        }
+        expectEqual("size after eviction", Capacity, trail.size());
+    }
+
+    // 只移动浮动节点的输入点只重新计算最新的一个线段
+    void mergeComputesOneSegment(TrailPath::Storage storage) {
+        TrailPath trail(16, storage);
+        trail.setResampling({4.0f, std::chrono::milliseconds(0)});
+
+        trail.addPoint({100.0, 100.0});
+        trail.addPoint({101.0, 100.0});
+
+        const std::size_t before = trail.stats().computedSegments;
+        trail.addPoint({102.0, 100.0});
+        expectEqual("merged points", 1, trail.stats().mergedPoints);
+        expectEqual("nodes after merging", 2, trail.size());
+        expectEqual("segments computed per merged node", 1, trail.stats().computedSegments - before);
+    }
+
+    // 沿同一条直线，无论输入点多密，固定节点都落在每 4 像素处；末尾不足 4 像素时由浮动节点连到最后一个输入点
+    void spacingIndependentOfInputRate(TrailPath::Storage storage) {
+        constexpr float  Spacing = 4.0f;
+        constexpr double Length  = 102.0;
+        const QPointF origin(100.0, 100.0);
+        const QPointF direction(0.6, 0.8);
+
+        for (const double step : {0.25, 1.0, 3.0, 10.0, 50.0}) {
+            TrailPath trail(64, storage);
+            trail.setResampling({Spacing, std::chrono::milliseconds(0)});
+            for (double d = 0.0; d < Length; d += step) trail.addPoint(origin + direction * d);
+            trail.addPoint(origin + direction * Length);
+
+            const std::size_t fixed = static_cast<std::size_t>(Length / Spacing) + 1;
+            expectEqual("nodes along a straight line", fixed + 1, trail.size());
+            std::size_t misplaced = 0;
+            for (std::size_t i = 0; i < trail.size(); ++i) {
+                const double along = i < fixed ? static_cast<double>(i) * Spacing : Length;
+                const QPointF error = trail.node(i).pos - (origin + direction * along);
+                if (std::abs(error.x()) > 1e-3 || std::abs(error.y()) > 1e-3) ++misplaced;
+            }
+            expectEqual("nodes off the fixed spacing", 0, misplaced);
+        }
+    }
+
+    // radius / percent 只影响每帧的偏移量，不使缓存失效
+    void drawingReusesCache(TrailPath::Storage storage) {
+        constexpr std::size_t Nodes = 64;
+        TrailPath trail(Nodes, storage);
+        for (std::size_t i = 0; i < Nodes; ++i) trail.addPoint(spiral(i));
+
+        const std::size_t computed = trail.stats().computedSegments;
+        std::size_t frames = 0;
+        for (const float radius : {1.0f, 12.5f, 40.0f, 300.0f}) {
+            for (const float percent : {1.0f, 0.75f, 0.5f, 0.1f}) {
+                const std::size_t drawn = drawnSegments(trail, radius, percent);
+                check(drawn > 0, "segments drawn", 1, drawn);
+                ++frames;
+            }
+        }
+        expectEqual("segments computed while drawing", computed, trail.stats().computedSegments);
+        expectEqual("frames", frames, trail.stats().frames);
+        check(trail.stats().reusedSegments > 0, "segments reused from the cache", 1, trail.stats().reusedSegments);
+    }
+
+    // 修改容量与切换存储方式保留缓存行
+    void resizeKeepsCache() {
+        TrailPath trail(32, TrailPath::Storage::AoS);
+        for (std::size_t i = 0; i < 32; ++i) trail.addPoint(spiral(i));
+
+        const std::size_t computed = trail.stats().computedSegments;
+        trail.setCapacity(48);
+        trail.setStorage(TrailPath::Storage::SoA);
+        drawnSegments(trail, 40.0f, 1.0f);
+        expectEqual("segments computed after setCapacity / setStorage", computed, trail.stats().computedSegments);
+    }
+
+}
+
+int main() {
+    for (const TrailPath::Storage storage : {TrailPath::Storage::AoS, TrailPath::Storage::SoA}) {
+        pushComputesOneSegment(storage);
+        mergeComputesOneSegment(storage);
+        spacingIndependentOfInputRate(storage);
+        drawingReusesCache(storage);
+    }
+    resizeKeepsCache();
+
+    if (failures != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("TrailPath: all checks passed\n");
+    return 0;
+}